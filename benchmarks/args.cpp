@@ -0,0 +1,79 @@
+#include "bench.h"
+#include <string>
+#include <string_view>
+
+namespace
+{
+
+const char *s_script = R""(
+local f = Args.%s
+return function(n)
+    for i = 1, n do f(%s) end
+end
+)"";
+
+} // namespace
+
+// unpack 1 to 8 arguments from the lua stack
+BENCHMARK_CASE(args)
+{
+    const int N = 1000000;
+
+    bench::Lua lua;
+    auto L = lua.L;
+
+    struct Args
+    {
+    };
+    using S = const std::string &;
+    using V = std::string_view;
+    static perilune::UserType<Args *> argsType;
+    argsType
+        .StaticMethod("f1", [](float a) { return a; })
+        .StaticMethod("f2", [](float a, float b) { return a + b; })
+        .StaticMethod("f4", [](float a, float b, float c, float d) { return a + b + c + d; })
+        .StaticMethod("f8", [](float a, float b, float c, float d, float e, float f, float g, float h) {
+            return a + b + c + d + e + f + g + h;
+        })
+        .StaticMethod("s1", [](std::string a) { return (int)a.size(); })
+        .StaticMethod("s2", [](std::string a, std::string b) { return (int)(a.size() + b.size()); })
+        .StaticMethod("s4", [](S a, S b, S c, S d) { return (int)(a.size() + b.size() + c.size() + d.size()); })
+        .StaticMethod("s8", [](S a, S b, S c, S d, S e, S f, S g, S h) {
+            return (int)(a.size() + b.size() + c.size() + d.size() + e.size() + f.size() + g.size() + h.size());
+        })
+        .StaticMethod("r3", [](float a) { return std::make_tuple(true, a, a); })
+        .StaticMethod("t3", [](float a) { return std::array<float, 3>{1, a, a}; })
+        .StaticMethod("v4", [](V a, V b, V c, V d) { return (int)(a.size() + b.size() + c.size() + d.size()); })
+        .StaticMethod("v8", [](V a, V b, V c, V d, V e, V f, V g, V h) {
+            return (int)(a.size() + b.size() + c.size() + d.size() + e.size() + f.size() + g.size() + h.size());
+        })
+        .LuaNewType(L);
+    lua_setglobal(L, "Args");
+
+    struct Case
+    {
+        const char *Label;
+        const char *Name;
+        const char *Args;
+    };
+    const Case cases[] = {
+        {"f(float x1)", "f1", "i"},
+        {"f(float x2)", "f2", "i, 2"},
+        {"f(float x4)", "f4", "i, 2, 3, 4"},
+        {"f(float x8)", "f8", "i, 2, 3, 4, 5, 6, 7, 8"},
+        {"f(std::string x1)", "s1", "'a'"},
+        {"f(std::string x2)", "s2", "'a', 'b'"},
+        {"f(const std::string& x4)", "s4", "'a', 'b', 'c', 'd'"},
+        {"f(const std::string& x8)", "s8", "'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h'"},
+        {"f(std::string_view x4)", "v4", "'a', 'b', 'c', 'd'"},
+        {"f(std::string_view x8)", "v8", "'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h'"},
+        {"f() -> std::tuple<bool, float, float>", "r3", "i"},
+        {"f() -> std::array<float, 3> table", "t3", "i"},
+    };
+    for (auto &c : cases)
+    {
+        char script[512];
+        snprintf(script, sizeof(script), s_script, c.Name, c.Args);
+        bench::Measure(lua, c.Label, script, N);
+    }
+}
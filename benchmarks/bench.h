@@ -0,0 +1,133 @@
+#pragma once
+#include <perilune/perilune.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace bench
+{
+
+///
+/// lua_Alloc that counts the blocks requested by a lua_State
+///
+struct CountingAllocator
+{
+    uint64_t Blocks = 0;
+    uint64_t Bytes = 0;
+
+    static void *Alloc(void *ud, void *ptr, size_t osize, size_t nsize)
+    {
+        auto self = (CountingAllocator *)ud;
+        if (nsize == 0)
+        {
+            free(ptr);
+            return nullptr;
+        }
+        if (!ptr)
+        {
+            ++self->Blocks;
+            self->Bytes += nsize;
+        }
+        else if (nsize > osize)
+        {
+            self->Bytes += nsize - osize;
+        }
+        return realloc(ptr, nsize);
+    }
+};
+
+struct Lua
+{
+    CountingAllocator Allocator;
+    lua_State *L;
+
+    Lua()
+        : L(lua_newstate(&CountingAllocator::Alloc, &Allocator))
+    {
+        luaL_openlibs(L);
+    }
+
+    ~Lua()
+    {
+        lua_close(L);
+    }
+};
+
+///
+/// script must return function(n) that runs the measured body n times
+///
+inline void Measure(Lua &lua, const char *label, const char *script, int n)
+{
+    auto L = lua.L;
+    if (luaL_dostring(L, script) != LUA_OK)
+    {
+        std::cerr << label << ": " << lua_tostring(L, -1) << std::endl;
+        lua_pop(L, 1);
+        return;
+    }
+    int run = lua_gettop(L);
+
+    // warm up
+    lua_pushvalue(L, run);
+    lua_pushinteger(L, n / 10 + 1);
+    lua_call(L, 1, 0);
+
+    lua_gc(L, LUA_GCCOLLECT, 0);
+    auto blocks = lua.Allocator.Blocks;
+    auto bytes = lua.Allocator.Bytes;
+    auto start = std::chrono::high_resolution_clock::now();
+
+    lua_pushvalue(L, run);
+    lua_pushinteger(L, n);
+    if (lua_pcall(L, 1, 0, 0) != LUA_OK)
+    {
+        std::cerr << label << ": " << lua_tostring(L, -1) << std::endl;
+        lua_pop(L, 1);
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+    auto ns = std::chrono::duration<double, std::nano>(end - start).count();
+    lua_pop(L, 1);
+
+    std::cout
+        << std::left << std::setw(48) << label
+        << std::right << std::fixed << std::setprecision(1)
+        << std::setw(10) << (ns / n) << " ns/op"
+        << std::setprecision(2)
+        << std::setw(10) << (double)(lua.Allocator.Blocks - blocks) / n << " allocs/op"
+        << std::setw(10) << (double)(lua.Allocator.Bytes - bytes) / n << " bytes/op"
+        << std::endl;
+}
+
+using BenchmarkFunc = void (*)();
+
+struct Benchmark
+{
+    const char *Name;
+    BenchmarkFunc Func;
+};
+
+inline std::vector<Benchmark> &Benchmarks()
+{
+    static std::vector<Benchmark> s_benchmarks;
+    return s_benchmarks;
+}
+
+struct Register
+{
+    Register(const char *name, BenchmarkFunc f)
+    {
+        Benchmarks().push_back({name, f});
+    }
+};
+
+} // namespace bench
+
+#define BENCHMARK_CASE(NAME)                                       \
+    static void NAME();                                            \
+    static bench::Register NAME##_register(#NAME, &NAME);          \
+    static void NAME()
@@ -0,0 +1,76 @@
+#include "bench.h"
+#include <stdio.h>
+
+namespace
+{
+
+struct Counter
+{
+    int Value = 0;
+
+    int Next()
+    {
+        return ++Value;
+    }
+};
+
+void NewCounterType(lua_State *L, perilune::UserType<Counter *> &type, const char *name)
+{
+    type
+        .DefaultConstructorAndDestructor()
+        .MetaIndexDispatcher([](auto d) {
+            d->Method("next", &Counter::Next);
+        })
+        .LuaNewType(L);
+    lua_setglobal(L, name);
+}
+
+const char *s_script = R""(
+local counter = %s.new()
+return function(n)
+    for i = 1, n do
+        counter.next()
+    end
+end
+)"";
+
+} // namespace
+
+// obj.method() per call: new closure vs closure cached in the user value vs obj:method()
+BENCHMARK_CASE(bound_method)
+{
+    const int N = 1000000;
+    char script[256];
+
+    {
+        bench::Lua lua;
+        static perilune::UserType<Counter *> counterType;
+        NewCounterType(lua.L, counterType, "Counter");
+        snprintf(script, sizeof(script), s_script, "Counter");
+        bench::Measure(lua, "obj.next() closure per access", script, N);
+    }
+
+    {
+        bench::Lua lua;
+        static perilune::UserType<Counter *> cachedType;
+        cachedType.CacheBoundMethods();
+        NewCounterType(lua.L, cachedType, "CachedCounter");
+        snprintf(script, sizeof(script), s_script, "CachedCounter");
+        bench::Measure(lua, "obj.next() CacheBoundMethods", script, N);
+    }
+
+    {
+        bench::Lua lua;
+        static perilune::UserType<Counter *> colonType;
+        colonType.ColonCall();
+        NewCounterType(lua.L, colonType, "ColonCounter");
+        bench::Measure(lua, "obj:next() ColonCall", R""(
+local counter = ColonCounter.new()
+return function(n)
+    for i = 1, n do
+        counter:next()
+    end
+end
+)"", N);
+    }
+}
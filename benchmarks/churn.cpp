@@ -0,0 +1,100 @@
+#include "bench.h"
+
+namespace
+{
+
+struct Vector3
+{
+    float x = 0;
+    float y = 0;
+    float z = 0;
+};
+
+const char *s_script = R""(
+local New = Vector3.New
+local s = Vector3.New()
+return function(n)
+    for i = 1, n do
+        local v = New()
+        local f = s.get_x
+    end
+end
+)"";
+
+// same as bench::Measure without the counting allocator
+void MeasureState(lua_State *L, const char *label, int n)
+{
+    // registered once. a metatable for each lua_State
+    static perilune::UserType<Vector3> &vector3Type = []() -> perilune::UserType<Vector3> & {
+        static perilune::UserType<Vector3> userType;
+        userType
+            .StaticMethod("New", []() { return Vector3{}; })
+            .MetaIndexDispatcher([](perilune::IndexDispatcher<Vector3> *d) {
+                d->Method("get_x", [](Vector3 *v) { return v->x; });
+            });
+        return userType;
+    }();
+    vector3Type.LuaNewType(L);
+    lua_setglobal(L, "Vector3");
+
+    if (luaL_dostring(L, s_script) != LUA_OK)
+    {
+        std::cerr << label << ": " << lua_tostring(L, -1) << std::endl;
+        lua_pop(L, 1);
+        return;
+    }
+    int run = lua_gettop(L);
+
+    lua_pushvalue(L, run);
+    lua_pushinteger(L, n / 10 + 1);
+    lua_call(L, 1, 0);
+    lua_gc(L, LUA_GCCOLLECT, 0);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    lua_pushvalue(L, run);
+    lua_pushinteger(L, n);
+    lua_call(L, 1, 0);
+    lua_gc(L, LUA_GCCOLLECT, 0);
+    auto end = std::chrono::high_resolution_clock::now();
+    lua_pop(L, 1);
+
+    auto ns = std::chrono::duration<double, std::nano>(end - start).count();
+    std::cout
+        << std::left << std::setw(48) << label
+        << std::right << std::fixed << std::setprecision(1)
+        << std::setw(10) << (ns / n) << " ns/op"
+        << std::endl;
+}
+
+} // namespace
+
+// userdata and bound method closure per iteration. libc realloc vs PoolAllocator
+BENCHMARK_CASE(churn)
+{
+    const int N = 1000000;
+
+    {
+        perilune::StateOptions options;
+        options.PooledAllocator = false;
+        auto L = perilune::NewState(options);
+        MeasureState(L, "libc: userdata + closure", N);
+        perilune::CloseState(L);
+    }
+
+    {
+        auto L = perilune::NewState();
+        MeasureState(L, "pooled: userdata + closure", N);
+
+        // per class counters
+        auto &stats = perilune::GetPoolAllocator(L)->Stats();
+        for (auto &c : stats)
+        {
+            if (c.Blocks >= N)
+            {
+                std::cout << "  " << std::setw(4) << c.Size << " bytes: "
+                          << c.Blocks << " blocks, " << c.Bytes << " bytes" << std::endl;
+            }
+        }
+        perilune::CloseState(L);
+    }
+}
@@ -0,0 +1,65 @@
+#include "bench.h"
+
+namespace
+{
+
+struct Vector3
+{
+    float x = 0;
+    float y = 0;
+    float z = 0;
+};
+
+using Vector3List = std::vector<Vector3>;
+
+} // namespace
+
+// list[i] for std::vector<T>* userdata
+BENCHMARK_CASE(container)
+{
+    const int N = 1000;
+
+    bench::Lua lua;
+    auto L = lua.L;
+
+    static perilune::UserType<Vector3> vector3Type;
+    vector3Type
+        .MetaIndexDispatcher([](perilune::IndexDispatcher<Vector3> *d) {
+            d->Getter("x", &Vector3::x);
+        })
+        .LuaNewType(L);
+    lua_setglobal(L, "Vector3");
+
+    static perilune::UserType<Vector3List *> vector3ListType;
+    perilune::AddDefaultMethods(vector3ListType);
+    vector3ListType
+        .StaticMethod("New", [](int n) { return new Vector3List(n); })
+        .LuaNewType(L);
+    lua_setglobal(L, "Vector3List");
+
+    bench::Measure(lua, "list[i] (1000 elements)", R""(
+local list = Vector3List.New(1000)
+return function(n)
+    for j = 1, n do
+        for i = 1, #list do local v = list[i] end
+    end
+end
+)"",
+                   N);
+
+    // a[i] for TypedArray<float> value userdata
+    static perilune::UserType<perilune::TypedArray<float>> floatArrayType;
+    perilune::AddTypedArrayMethods(floatArrayType);
+    floatArrayType.LuaNewType(L);
+    lua_setglobal(L, "FloatArray");
+
+    bench::Measure(lua, "typed array a[i] = a[i] + 1 (1000 elements)", R""(
+local a = FloatArray.new(1000)
+return function(n)
+    for j = 1, n do
+        for i = 1, #a do a[i] = a[i] + 1 end
+    end
+end
+)"",
+                   N);
+}
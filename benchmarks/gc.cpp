@@ -0,0 +1,96 @@
+#include "bench.h"
+
+namespace
+{
+
+struct Vector3
+{
+    float x = 0;
+    float y = 0;
+    float z = 0;
+};
+
+// same as Vector3. the userdata gets an empty __gc by MetaMethod
+struct FinalizedVector3
+{
+    float x = 0;
+    float y = 0;
+    float z = 0;
+};
+
+} // namespace
+
+// full collect with 1M live vectors, and create and collect dead vectors
+BENCHMARK_CASE(gc)
+{
+    const int N = 10;
+
+    bench::Lua lua;
+    auto L = lua.L;
+
+    static perilune::UserType<Vector3> vector3Type;
+    vector3Type
+        .StaticMethod("New", []() { return Vector3{}; })
+        .LuaNewType(L);
+    lua_setglobal(L, "Vector3");
+
+    static perilune::UserType<FinalizedVector3> finalizedVector3Type;
+    finalizedVector3Type
+        .StaticMethod("New", []() { return FinalizedVector3{}; })
+        .MetaMethod(perilune::MetaKey::__gc, [](FinalizedVector3 *) {})
+        .LuaNewType(L);
+    lua_setglobal(L, "FinalizedVector3");
+
+    const char *script = R""(
+local New = %s.New
+list = {}
+for i = 1, 1000000 do list[i] = New() end
+return function(n)
+    for i = 1, n do collectgarbage() end
+end
+)"";
+
+    const char *release = R""(
+list = nil
+collectgarbage()
+collectgarbage()
+)"";
+
+    char buf[512];
+    snprintf(buf, sizeof(buf), script, "Vector3");
+    bench::Measure(lua, "full gc, 1M live Vector3 (no __gc)", buf, N);
+    luaL_dostring(L, release);
+
+    snprintf(buf, sizeof(buf), script, "FinalizedVector3");
+    bench::Measure(lua, "full gc, 1M live Vector3 (__gc)", buf, N);
+    luaL_dostring(L, release);
+
+    // finalizers run for each dead object
+    bench::Measure(lua, "create and collect 100k Vector3 (no __gc)", R""(
+local New = Vector3.New
+return function(n)
+    for i = 1, n do
+        local list = {}
+        for j = 1, 100000 do list[j] = New() end
+        list = nil
+        collectgarbage()
+        collectgarbage()
+    end
+end
+)"",
+                   N);
+
+    bench::Measure(lua, "create and collect 100k Vector3 (__gc)", R""(
+local New = FinalizedVector3.New
+return function(n)
+    for i = 1, n do
+        local list = {}
+        for j = 1, 100000 do list[j] = New() end
+        list = nil
+        collectgarbage()
+        collectgarbage()
+    end
+end
+)"",
+                   N);
+}
@@ -0,0 +1,97 @@
+#include "bench.h"
+#include <algorithm>
+
+namespace
+{
+
+struct Vector3
+{
+    float x = 0;
+    float y = 0;
+    float z = 0;
+};
+
+const char *FrameScript = R""(
+-- a long lived heap and the garbage of a frame
+world = {}
+for i = 1, 200000 do world[i] = Vector3.new() end
+return function()
+    local list = {}
+    for i = 1, 5000 do list[i] = Vector3.new() end
+    -- replace some of the long lived
+    for i = 1, 100 do world[math.random(#world)] = list[i] end
+end
+)"";
+
+// frame time with GC by the automatic collector or by GcBudget at the end of each frame
+void MeasureFrames(const char *label, perilune::GcMode mode, bool budget)
+{
+    const int N = 1000;
+
+    bench::Lua lua;
+    auto L = lua.L;
+    if (mode == perilune::GcMode::Generational)
+    {
+        lua_gc(L, LUA_GCGEN, 0, 0);
+    }
+
+    static perilune::UserType<Vector3> vector3Type;
+    vector3Type
+        .StaticMethod("new", []() { return Vector3{}; })
+        .LuaNewType(L);
+    lua_setglobal(L, "Vector3");
+
+    luaL_dostring(L, FrameScript);
+    int frame = lua_gettop(L);
+
+    std::unique_ptr<perilune::GcBudget> gc;
+    if (budget)
+    {
+        perilune::GcBudgetOptions options;
+        options.Mode = mode;
+        options.BudgetMicroseconds = 1000;
+        gc.reset(new perilune::GcBudget(L, options));
+    }
+
+    std::vector<double> times;
+    times.reserve(N);
+    for (int i = 0; i < N; ++i)
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+        lua_pushvalue(L, frame);
+        lua_call(L, 0, 0);
+        if (gc)
+        {
+            gc->Step();
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        times.push_back(std::chrono::duration<double, std::micro>(end - start).count());
+    }
+    auto heapKB = lua_gc(L, LUA_GCCOUNT, 0);
+    gc.reset();
+
+    std::sort(times.begin(), times.end());
+    double total = 0;
+    for (auto t : times)
+    {
+        total += t;
+    }
+    std::cout
+        << std::left << std::setw(48) << label
+        << std::right << std::fixed << std::setprecision(1)
+        << std::setw(10) << (total / N) << " us/frame"
+        << std::setw(10) << times[N * 99 / 100] << " us p99"
+        << std::setw(10) << times.back() << " us max"
+        << std::setw(10) << heapKB << " KB"
+        << std::endl;
+}
+
+} // namespace
+
+BENCHMARK_CASE(gcbudget)
+{
+    MeasureFrames("frames, incremental (automatic)", perilune::GcMode::Incremental, false);
+    MeasureFrames("frames, incremental (GcBudget 1ms)", perilune::GcMode::Incremental, true);
+    MeasureFrames("frames, generational (automatic)", perilune::GcMode::Generational, false);
+    MeasureFrames("frames, generational (GcBudget 1ms)", perilune::GcMode::Generational, true);
+}
@@ -0,0 +1,81 @@
+#include "bench.h"
+
+namespace
+{
+
+struct Vector3
+{
+    float x = 0;
+    float y = 0;
+    float z = 0;
+
+    float SqNorm() const
+    {
+        return x * x + y * y + z * z;
+    }
+};
+
+} // namespace
+
+// __index lookup for getters, __newindex for setters
+BENCHMARK_CASE(index)
+{
+    const int N = 1000000;
+
+    bench::Lua lua;
+    auto L = lua.L;
+
+    static perilune::UserType<Vector3> vector3Type;
+    vector3Type
+        .PlacementNew("new")
+        .MetaIndexDispatcher([](perilune::IndexDispatcher<Vector3> *d) {
+            d->Getter("x", &Vector3::x);
+            d->Getter("y", [](Vector3 *v) { return v->y; });
+            d->Getter("a_long_getter_name_that_is_not_a_short_string_in_lua", &Vector3::z);
+            d->Method("sqnorm", &Vector3::SqNorm);
+            d->Setter("x", &Vector3::x);
+            d->Setter("y", [](Vector3 *v, float y) { v->y = y; });
+        })
+        .LuaNewType(L);
+    lua_setglobal(L, "Vector3");
+
+    bench::Measure(lua, "v.x field getter", R""(
+local v = Vector3.new()
+return function(n)
+    for i = 1, n do local x = v.x end
+end
+)"",
+                   N);
+
+    bench::Measure(lua, "v.y lambda getter", R""(
+local v = Vector3.new()
+return function(n)
+    for i = 1, n do local y = v.y end
+end
+)"",
+                   N);
+
+    bench::Measure(lua, "v.<long name> field getter", R""(
+local v = Vector3.new()
+return function(n)
+    for i = 1, n do local z = v.a_long_getter_name_that_is_not_a_short_string_in_lua end
+end
+)"",
+                   N);
+
+    bench::Measure(lua, "v.x = i field setter", R""(
+local v = Vector3.new()
+return function(n)
+    for i = 1, n do v.x = i end
+end
+)"",
+                   N);
+
+    bench::Measure(lua, "v.y = i lambda setter", R""(
+local v = Vector3.new()
+return function(n)
+    for i = 1, n do v.y = i end
+end
+)"",
+                   N);
+}
@@ -0,0 +1,65 @@
+#include "bench.h"
+
+namespace
+{
+
+struct Vector3
+{
+    float x = 0;
+    float y = 0;
+    float z = 0;
+
+    Vector3 operator+(const Vector3 &v) const
+    {
+        return Vector3{x + v.x, y + v.y, z + v.z};
+    }
+
+    Vector3 &operator+=(const Vector3 &v)
+    {
+        x += v.x;
+        y += v.y;
+        z += v.z;
+        return *this;
+    }
+};
+
+} // namespace
+
+// acc = acc + v vs acc.add_(v)
+BENCHMARK_CASE(inplace)
+{
+    const int N = 1000000;
+
+    bench::Lua lua;
+    auto L = lua.L;
+
+    static perilune::UserType<Vector3> vector3Type;
+    vector3Type
+        .StaticMethod("New", [](float x, float y, float z) { return Vector3{x, y, z}; })
+        .MetaMethod(perilune::MetaKey::__add, [](Vector3 *a, const Vector3 &b) { return *a + b; })
+        .MetaIndexDispatcher([](perilune::IndexDispatcher<Vector3> *d) {
+            d->Getter("x", &Vector3::x);
+            d->InPlaceAdd();
+        })
+        .CacheBoundMethods()
+        .LuaNewType(L);
+    lua_setglobal(L, "Vector3");
+
+    bench::Measure(lua, "acc = acc + v", R""(
+local v = Vector3.New(1, 2, 3)
+return function(n)
+    local acc = Vector3.New(0, 0, 0)
+    for i = 1, n do acc = acc + v end
+end
+)"",
+                   N);
+
+    bench::Measure(lua, "acc.add_(v)", R""(
+local v = Vector3.New(1, 2, 3)
+return function(n)
+    local acc = Vector3.New(0, 0, 0)
+    for i = 1, n do acc.add_(v) end
+end
+)"",
+                   N);
+}
@@ -0,0 +1,21 @@
+#include "bench.h"
+#include <string.h>
+
+// usage: benchmarks [filter]
+int main(int argc, char **argv)
+{
+    auto filter = argc > 1 ? argv[1] : "";
+
+    for (auto &b : bench::Benchmarks())
+    {
+        if (!strstr(b.Name, filter))
+        {
+            continue;
+        }
+        std::cout << "## " << b.Name << std::endl;
+        b.Func();
+        std::cout << std::endl;
+    }
+
+    return 0;
+}
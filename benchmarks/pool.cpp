@@ -0,0 +1,58 @@
+#include "bench.h"
+
+namespace
+{
+
+struct Particle
+{
+    float Position[3] = {};
+    float Velocity[3] = {};
+    float Life = 0;
+};
+
+// the metatable is per type
+struct PooledParticle : Particle
+{
+};
+
+} // namespace
+
+// Particle.new() and __gc by new/delete and by the slab pool
+BENCHMARK_CASE(pool)
+{
+    const int N = 10;
+
+    bench::Lua lua;
+    auto L = lua.L;
+
+    static perilune::UserType<Particle *> heapType;
+    heapType
+        .DefaultConstructorAndDestructor()
+        .LuaNewType(L);
+    lua_setglobal(L, "HeapParticle");
+
+    static perilune::UserType<PooledParticle *> pooledType;
+    pooledType
+        .Pooled(4096)
+        .LuaNewType(L);
+    lua_setglobal(L, "PooledParticle");
+
+    const char *script = R""(
+local New = %s.new
+return function(n)
+    for i = 1, n do
+        local list = {}
+        for j = 1, 100000 do list[j] = New() end
+        list = nil
+        collectgarbage()
+    end
+end
+)"";
+
+    char buf[512];
+    snprintf(buf, sizeof(buf), script, "HeapParticle");
+    bench::Measure(lua, "create and collect 100k Particle* (new/delete)", buf, N);
+
+    snprintf(buf, sizeof(buf), script, "PooledParticle");
+    bench::Measure(lua, "create and collect 100k Particle* (Pooled)", buf, N);
+}
@@ -0,0 +1,77 @@
+#include "bench.h"
+
+namespace
+{
+
+struct Vector3
+{
+    float x = 0;
+    float y = 0;
+    float z = 0;
+};
+
+struct ScalarVector3
+{
+    float x = 0;
+    float y = 0;
+    float z = 0;
+};
+
+template <typename T>
+void AddFields(perilune::IndexDispatcher<T> *d)
+{
+    d->Getter("x", &T::x);
+    d->Getter("y", &T::y);
+    d->Getter("z", &T::z);
+}
+
+} // namespace
+
+// Vector3 result as userdata vs ReturnAsScalars
+BENCHMARK_CASE(scalars)
+{
+    const int N = 1000000;
+
+    bench::Lua lua;
+    auto L = lua.L;
+
+    static perilune::UserType<Vector3> vector3Type;
+    vector3Type
+        .StaticMethod("New", [](float x, float y, float z) { return Vector3{x, y, z}; })
+        .StaticMethod("Add", [](const Vector3 &a, const Vector3 &b) {
+            return Vector3{a.x + b.x, a.y + b.y, a.z + b.z};
+        })
+        .MetaIndexDispatcher(&AddFields<Vector3>)
+        .LuaNewType(L);
+    lua_setglobal(L, "Vector3");
+
+    static perilune::UserType<ScalarVector3> scalarVector3Type;
+    scalarVector3Type
+        .ReturnAsScalars()
+        .StaticMethod("New", [](float x, float y, float z) { return ScalarVector3{x, y, z}; })
+        .StaticMethod("Add", [](const ScalarVector3 &a, const ScalarVector3 &b) {
+            return ScalarVector3{a.x + b.x, a.y + b.y, a.z + b.z};
+        })
+        .MetaIndexDispatcher(&AddFields<ScalarVector3>)
+        .LuaNewType(L);
+    lua_setglobal(L, "ScalarVector3");
+
+    bench::Measure(lua, "v = Add(v, w) userdata", R""(
+local Add = Vector3.Add
+local w = Vector3.New(1, 2, 3)
+return function(n)
+    local v = Vector3.New(0, 0, 0)
+    for i = 1, n do v = Add(v, w) end
+end
+)"",
+                   N);
+
+    bench::Measure(lua, "x, y, z = Add(x, y, z, 1, 2, 3) scalars", R""(
+local Add = ScalarVector3.Add
+return function(n)
+    local x, y, z = 0, 0, 0
+    for i = 1, n do x, y, z = Add(x, y, z, 1, 2, 3) end
+end
+)"",
+                   N);
+}
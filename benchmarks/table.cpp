@@ -0,0 +1,209 @@
+#include "bench.h"
+
+namespace
+{
+
+const int SIZE = 1000000;
+
+std::vector<float> &Values()
+{
+    static std::vector<float> s_values(SIZE, 1.0f);
+    return s_values;
+}
+
+// previous helpers. lua_settable / lua_gettable and push_back without reserve
+int LegacyPush(lua_State *L)
+{
+    auto &values = Values();
+    lua_newtable(L);
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        lua_pushinteger(L, static_cast<lua_Integer>(i + 1));
+        lua_pushnumber(L, values[i]);
+        lua_settable(L, -3);
+    }
+    return 1;
+}
+
+int LegacyGet(lua_State *L)
+{
+    auto length = static_cast<lua_Integer>(lua_rawlen(L, 1));
+    std::vector<float> list;
+    for (lua_Integer i = 1; i <= length; ++i)
+    {
+        lua_pushinteger(L, i);
+        lua_gettable(L, 1);
+        list.push_back((float)lua_tonumber(L, -1));
+        lua_pop(L, 1);
+    }
+    lua_pushinteger(L, list.size());
+    return 1;
+}
+
+int Push(lua_State *L)
+{
+    return perilune::LuaPush<std::vector<float>>::Push(L, Values());
+}
+
+int Get(lua_State *L)
+{
+    auto list = perilune::LuaGet<std::vector<float>>::Get(L, 1);
+    lua_pushinteger(L, list.size());
+    return 1;
+}
+
+struct Vector3
+{
+    float x = 0;
+    float y = 0;
+    float z = 0;
+};
+
+// hand written named field access. hashes "x", "y", "z" per call
+int GetFieldSum(lua_State *L)
+{
+    Vector3 v;
+    lua_getfield(L, 1, "x");
+    v.x = (float)lua_tonumber(L, -1);
+    lua_getfield(L, 1, "y");
+    v.y = (float)lua_tonumber(L, -1);
+    lua_getfield(L, 1, "z");
+    v.z = (float)lua_tonumber(L, -1);
+    lua_pop(L, 3);
+    lua_pushnumber(L, v.x + v.y + v.z);
+    return 1;
+}
+
+// field list registered by Getter
+int StructFieldsSum(lua_State *L)
+{
+    auto v = perilune::LuaGet<Vector3>::Get(L, 1);
+    lua_pushnumber(L, v.x + v.y + v.z);
+    return 1;
+}
+
+int SetFieldTable(lua_State *L)
+{
+    Vector3 v{1, 2, 3};
+    lua_createtable(L, 0, 3);
+    lua_pushnumber(L, v.x);
+    lua_setfield(L, -2, "x");
+    lua_pushnumber(L, v.y);
+    lua_setfield(L, -2, "y");
+    lua_pushnumber(L, v.z);
+    lua_setfield(L, -2, "z");
+    return 1;
+}
+
+int StructFieldsTable(lua_State *L)
+{
+    return perilune::LuaTable<Vector3>::Push(L, Vector3{1, 2, 3});
+}
+
+} // namespace
+
+// std::vector<float> <-> table with 1M elements
+BENCHMARK_CASE(table)
+{
+    const int N = 20;
+
+    bench::Lua lua;
+    auto L = lua.L;
+
+    lua_register(L, "LegacyPush", &LegacyPush);
+    lua_register(L, "LegacyGet", &LegacyGet);
+    lua_register(L, "Push", &Push);
+    lua_register(L, "Get", &Get);
+
+    bench::Measure(lua, "legacy vector -> table (1M floats)", R""(
+return function(n)
+    for i = 1, n do local t = LegacyPush() end
+end
+)"",
+                   N);
+
+    bench::Measure(lua, "vector -> table (1M floats)", R""(
+return function(n)
+    for i = 1, n do local t = Push() end
+end
+)"",
+                   N);
+
+    bench::Measure(lua, "legacy table -> vector (1M floats)", R""(
+local t = Push()
+return function(n)
+    for i = 1, n do LegacyGet(t) end
+end
+)"",
+                   N);
+
+    bench::Measure(lua, "table -> vector (1M floats)", R""(
+local t = Push()
+return function(n)
+    for i = 1, n do Get(t) end
+end
+)"",
+                   N);
+}
+
+// Vector3 argument from {x = 1, y = 2, z = 3} or {1, 2, 3}
+BENCHMARK_CASE(struct_table)
+{
+    const int N = 1000000;
+
+    bench::Lua lua;
+    auto L = lua.L;
+
+    lua_register(L, "GetFieldSum", &GetFieldSum);
+    lua_register(L, "StructFieldsSum", &StructFieldsSum);
+    lua_register(L, "SetFieldTable", &SetFieldTable);
+    lua_register(L, "StructFieldsTable", &StructFieldsTable);
+
+    static perilune::UserType<Vector3> vector3Type;
+    vector3Type
+        .MetaIndexDispatcher([](perilune::IndexDispatcher<Vector3> *d) {
+            d->Getter("x", &Vector3::x);
+            d->Getter("y", &Vector3::y);
+            d->Getter("z", &Vector3::z);
+        })
+        .LuaNewType(L);
+    lua_setglobal(L, "Vector3");
+
+    bench::Measure(lua, "lua_getfield {x, y, z}", R""(
+local t = {x = 1, y = 2, z = 3}
+return function(n)
+    for i = 1, n do GetFieldSum(t) end
+end
+)"",
+                   N);
+
+    bench::Measure(lua, "Vector3 from {x, y, z}", R""(
+local t = {x = 1, y = 2, z = 3}
+return function(n)
+    for i = 1, n do StructFieldsSum(t) end
+end
+)"",
+                   N);
+
+    bench::Measure(lua, "Vector3 from {1, 2, 3}", R""(
+local t = {1, 2, 3}
+return function(n)
+    for i = 1, n do StructFieldsSum(t) end
+end
+)"",
+                   N);
+
+    bench::Measure(lua, "lua_setfield {x, y, z}", R""(
+return function(n)
+    for i = 1, n do SetFieldTable() end
+end
+)"",
+                   N);
+
+    bench::Measure(lua, "Vector3 to {x, y, z}", R""(
+return function(n)
+    for i = 1, n do StructFieldsTable() end
+end
+)"",
+                   N);
+}
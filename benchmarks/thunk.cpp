@@ -0,0 +1,111 @@
+#include "bench.h"
+
+namespace
+{
+
+struct Vector3
+{
+    float x = 0;
+    float y = 0;
+    float z = 0;
+
+    float SqNorm() const
+    {
+        return x * x + y * y + z * z;
+    }
+};
+
+float Add(float a, float b)
+{
+    return a + b;
+}
+
+// hand written baseline
+int LuaSqNorm(lua_State *L)
+{
+    auto v = *perilune::LuaCheckUserData<Vector3 *>(L, 1);
+    lua_pushnumber(L, v->SqNorm());
+    return 1;
+}
+
+int LuaAdd(lua_State *L)
+{
+    lua_pushnumber(L, luaL_checknumber(L, 1) + luaL_checknumber(L, 2));
+    return 1;
+}
+
+} // namespace
+
+// std::function LuaFunc vs template <auto F> thunk vs lua_CFunction
+BENCHMARK_CASE(thunk)
+{
+    const int N = 1000000;
+
+    bench::Lua lua;
+    auto L = lua.L;
+
+    static perilune::UserType<Vector3 *> vector3Type;
+    vector3Type
+        .DefaultConstructorAndDestructor()
+        .StaticMethod("add", [](float a, float b) { return a + b; })
+        .StaticMethod<&Add>("add_thunk")
+        .ColonCall()
+        .MetaIndexDispatcher([](perilune::IndexDispatcher<Vector3 *> *d) {
+            d->Method("sqnorm", &Vector3::SqNorm);
+            d->Method<&Vector3::SqNorm>("sqnorm_thunk");
+        })
+        .LuaNewType(L);
+    lua_setglobal(L, "Vector3");
+
+    lua_register(L, "c_sqnorm", &LuaSqNorm);
+    lua_register(L, "c_add", &LuaAdd);
+
+    bench::Measure(lua, "v:sqnorm() LuaFunc", R""(
+local v = Vector3.new()
+return function(n)
+    for i = 1, n do v:sqnorm() end
+end
+)"",
+                   N);
+
+    bench::Measure(lua, "v:sqnorm() Method<&Vector3::SqNorm>", R""(
+local v = Vector3.new()
+return function(n)
+    for i = 1, n do v:sqnorm_thunk() end
+end
+)"",
+                   N);
+
+    bench::Measure(lua, "c_sqnorm(v) lua_CFunction", R""(
+local v = Vector3.new()
+local c_sqnorm = c_sqnorm
+return function(n)
+    for i = 1, n do c_sqnorm(v) end
+end
+)"",
+                   N);
+
+    bench::Measure(lua, "add(a, b) LuaFunc", R""(
+local add = Vector3.add
+return function(n)
+    for i = 1, n do add(i, 1) end
+end
+)"",
+                   N);
+
+    bench::Measure(lua, "add(a, b) StaticMethod<&Add>", R""(
+local add = Vector3.add_thunk
+return function(n)
+    for i = 1, n do add(i, 1) end
+end
+)"",
+                   N);
+
+    bench::Measure(lua, "c_add(a, b) lua_CFunction", R""(
+local c_add = c_add
+return function(n)
+    for i = 1, n do c_add(i, 1) end
+end
+)"",
+                   N);
+}
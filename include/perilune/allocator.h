@@ -0,0 +1,332 @@
+#pragma once
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <array>
+#include <vector>
+#include "common.h"
+
+namespace perilune
+{
+
+///
+/// counters of a size class
+///
+struct SizeClassStats
+{
+    // block size. 0 for the blocks larger than PoolAllocator::MaxPooledSize
+    size_t Size = 0;
+    // allocations
+    uint64_t Blocks = 0;
+    // requested bytes
+    uint64_t Bytes = 0;
+    // allocated and not freed
+    uint64_t Live = 0;
+};
+
+///
+/// lua_Alloc with free lists for each 16 byte size class.
+/// a lua_State owns one. blocks are carved from pages and returned to the free list.
+///
+/// pointer userdata (header + 8), value userdata (header + 12..64) and
+/// C closures with 2 upvalues are 48 to 128 bytes.
+///
+class PoolAllocator
+{
+public:
+    static const size_t Alignment = 16;
+    static const size_t MaxPooledSize = 256;
+    static const size_t ClassCount = MaxPooledSize / Alignment;
+    static const size_t PageSize = 64 * 1024;
+
+private:
+    struct FreeBlock
+    {
+        FreeBlock *Next;
+    };
+
+    struct SizeClass
+    {
+        FreeBlock *Free = nullptr;
+        // unused tail of the current page
+        char *Head = nullptr;
+        char *End = nullptr;
+    };
+
+    std::array<SizeClass, ClassCount> m_classes;
+    std::vector<void *> m_pages;
+
+    // [0, ClassCount): pooled, [ClassCount]: larger blocks
+    std::array<SizeClassStats, ClassCount + 1> m_stats;
+
+    static size_t ClassIndex(size_t size)
+    {
+        return (size + Alignment - 1) / Alignment - 1;
+    }
+
+    void *AllocBlock(size_t size)
+    {
+        if (size > MaxPooledSize)
+        {
+            auto &stats = m_stats[ClassCount];
+            ++stats.Blocks;
+            ++stats.Live;
+            stats.Bytes += size;
+            return malloc(size);
+        }
+
+        auto index = ClassIndex(size);
+        auto &stats = m_stats[index];
+        ++stats.Blocks;
+        ++stats.Live;
+        stats.Bytes += size;
+
+        auto &c = m_classes[index];
+        if (c.Free)
+        {
+            auto block = c.Free;
+            c.Free = block->Next;
+            return block;
+        }
+
+        auto blockSize = (index + 1) * Alignment;
+        if (c.Head + blockSize > c.End)
+        {
+            auto page = static_cast<char *>(malloc(PageSize));
+            if (!page)
+            {
+                return nullptr;
+            }
+            m_pages.push_back(page);
+            c.Head = page;
+            c.End = page + PageSize;
+        }
+        auto block = c.Head;
+        c.Head += blockSize;
+        return block;
+    }
+
+    void ReleaseBlock(void *p, size_t size)
+    {
+        if (size > MaxPooledSize)
+        {
+            --m_stats[ClassCount].Live;
+            free(p);
+            return;
+        }
+
+        auto index = ClassIndex(size);
+        --m_stats[index].Live;
+        auto block = static_cast<FreeBlock *>(p);
+        block->Next = m_classes[index].Free;
+        m_classes[index].Free = block;
+    }
+
+public:
+    PoolAllocator()
+    {
+        for (size_t i = 0; i < ClassCount; ++i)
+        {
+            m_stats[i].Size = (i + 1) * Alignment;
+        }
+    }
+
+    ~PoolAllocator()
+    {
+        for (auto page : m_pages)
+        {
+            free(page);
+        }
+    }
+
+    PoolAllocator(const PoolAllocator &) = delete;
+    PoolAllocator &operator=(const PoolAllocator &) = delete;
+
+    // size classes and the larger blocks at the end
+    const std::array<SizeClassStats, ClassCount + 1> &Stats() const
+    {
+        return m_stats;
+    }
+
+    size_t PageBytes() const
+    {
+        return m_pages.size() * PageSize;
+    }
+
+    // lua_Alloc
+    static void *Alloc(void *ud, void *ptr, size_t osize, size_t nsize)
+    {
+        auto self = static_cast<PoolAllocator *>(ud);
+        if (nsize == 0)
+        {
+            if (ptr)
+            {
+                self->ReleaseBlock(ptr, osize);
+            }
+            return nullptr;
+        }
+
+        if (!ptr)
+        {
+            // osize is the lua type of the new object
+            return self->AllocBlock(nsize);
+        }
+
+        if (osize > MaxPooledSize && nsize > MaxPooledSize)
+        {
+            // large to large
+            auto &stats = self->m_stats[ClassCount];
+            ++stats.Blocks;
+            stats.Bytes += nsize;
+            return realloc(ptr, nsize);
+        }
+
+        if (osize <= MaxPooledSize && nsize <= MaxPooledSize && ClassIndex(osize) == ClassIndex(nsize))
+        {
+            // same block
+            return ptr;
+        }
+
+        auto p = self->AllocBlock(nsize);
+        if (!p)
+        {
+            // lua keeps the old block
+            return nullptr;
+        }
+        memcpy(p, ptr, std::min(osize, nsize));
+        self->ReleaseBlock(ptr, osize);
+        return p;
+    }
+};
+
+struct StateOptions
+{
+    // PoolAllocator or the libc allocator of luaL_newstate
+    bool PooledAllocator = true;
+    // luaL_openlibs. false: only the base library
+    bool OpenLibs = true;
+};
+
+inline int LuaPanic(lua_State *L)
+{
+    auto msg = lua_tostring(L, -1);
+    fprintf(stderr, "PANIC: unprotected error in call to Lua API (%s)\n", msg ? msg : "error object is not a string");
+    return 0;
+}
+
+// warning functions of luaL_newstate. off until warn("@on")
+inline void LuaWarnOff(void *ud, const char *message, int tocont);
+inline void LuaWarnOn(void *ud, const char *message, int tocont);
+
+// "@on" / "@off"
+inline bool LuaWarnControl(lua_State *L, const char *message, int tocont)
+{
+    if (tocont || *message != '@')
+    {
+        return false;
+    }
+    if (strcmp(message + 1, "off") == 0)
+    {
+        lua_setwarnf(L, &LuaWarnOff, L);
+    }
+    else if (strcmp(message + 1, "on") == 0)
+    {
+        lua_setwarnf(L, &LuaWarnOn, L);
+    }
+    return true;
+}
+
+inline void LuaWarnOff(void *ud, const char *message, int tocont)
+{
+    LuaWarnControl(static_cast<lua_State *>(ud), message, tocont);
+}
+
+// a message continued by tocont
+inline void LuaWarnCont(void *ud, const char *message, int tocont)
+{
+    auto L = static_cast<lua_State *>(ud);
+    fprintf(stderr, "%s", message);
+    if (tocont)
+    {
+        lua_setwarnf(L, &LuaWarnCont, L);
+    }
+    else
+    {
+        fprintf(stderr, "\n");
+        fflush(stderr);
+        lua_setwarnf(L, &LuaWarnOn, L);
+    }
+}
+
+inline void LuaWarnOn(void *ud, const char *message, int tocont)
+{
+    if (LuaWarnControl(static_cast<lua_State *>(ud), message, tocont))
+    {
+        return;
+    }
+    fprintf(stderr, "Lua warning: ");
+    LuaWarnCont(ud, message, tocont);
+}
+
+// close by CloseState
+inline lua_State *NewState(const StateOptions &options = {})
+{
+    lua_State *L = nullptr;
+    if (options.PooledAllocator)
+    {
+        auto allocator = new PoolAllocator;
+        L = lua_newstate(&PoolAllocator::Alloc, allocator);
+        if (!L)
+        {
+            delete allocator;
+            return nullptr;
+        }
+        lua_atpanic(L, &LuaPanic);
+        lua_setwarnf(L, &LuaWarnOff, L);
+    }
+    else
+    {
+        L = luaL_newstate();
+        if (!L)
+        {
+            return nullptr;
+        }
+    }
+
+    if (options.OpenLibs)
+    {
+        luaL_openlibs(L);
+    }
+    else
+    {
+        luaL_requiref(L, "_G", luaopen_base, 1);
+        lua_pop(L, 1);
+    }
+    return L;
+}
+
+// nullptr if L does not use PoolAllocator
+inline const PoolAllocator *GetPoolAllocator(lua_State *L)
+{
+    void *ud;
+    if (lua_getallocf(L, &ud) != &PoolAllocator::Alloc)
+    {
+        return nullptr;
+    }
+    return static_cast<PoolAllocator *>(ud);
+}
+
+inline void CloseState(lua_State *L)
+{
+    void *ud;
+    auto f = lua_getallocf(L, &ud);
+    lua_close(L);
+    if (f == &PoolAllocator::Alloc)
+    {
+        delete static_cast<PoolAllocator *>(ud);
+    }
+}
+
+} // namespace perilune
@@ -1,4 +1,5 @@
 #pragma once
+#include <utility>
 #include "common.h"
 
 namespace perilune
@@ -11,7 +12,7 @@ constexpr auto _OpenMethod(R (C::*m)(ARGS...))
     {
         static R call(C *self, ARGS... args)
         {
-            return (self->*M)(args...);
+            return (self->*M)(std::forward<ARGS>(args)...);
         }
     };
     return &inner::call;
@@ -40,8 +41,7 @@ struct Applyer
 {
     static int Apply(lua_State *L, typename Traits<T>::RawType *value, R (T::*m)(ARGS...), ARGS... args)
     {
-        auto r = (value->*m)(args...);
-        return LuaPush<R>::Push(L, r);
+        return LuaPushInvoke<R>(L, [&]() -> R { return (value->*m)(std::forward<ARGS>(args)...); });
     }
 };
 template <typename R, typename T, typename... ARGS>
@@ -49,7 +49,7 @@ struct Applyer<R &, T, ARGS...>
 {
     static int Apply(lua_State *L, typename Traits<T>::RawType *value, R &(T::*m)(ARGS...), ARGS... args)
     {
-        auto &r = (value->*m)(args...);
+        auto &r = (value->*m)(std::forward<ARGS>(args)...);
         return LuaPush<R *>::Push(L, &r);
     }
 };
@@ -58,7 +58,7 @@ struct Applyer<void, T, ARGS...>
 {
     static int Apply(lua_State *L, typename Traits<T>::RawType *value, void (T::*m)(ARGS...), ARGS... args)
     {
-        (value->*m)(args...);
+        (value->*m)(std::forward<ARGS>(args)...);
         return 0;
     }
 };
@@ -68,8 +68,7 @@ struct ConstApplyer
 {
     static int Apply(lua_State *L, typename Traits<T>::RawType *value, R (T::*m)(ARGS...) const, ARGS... args)
     {
-        auto r = (value->*m)(args...);
-        return LuaPush<R>::Push(L, r);
+        return LuaPushInvoke<R>(L, [&]() -> R { return (value->*m)(std::forward<ARGS>(args)...); });
     }
 };
 template <typename R, typename T, typename... ARGS>
@@ -77,7 +76,7 @@ struct ConstApplyer<R &, T, ARGS...>
 {
     static int Apply(lua_State *L, typename Traits<T>::RawType *value, R &(T::*m)(ARGS...) const, ARGS... args)
     {
-        auto &r = (value->*m)(args...);
+        auto &r = (value->*m)(std::forward<ARGS>(args)...);
         return LuaPush<R *>::Push(L, &r);
     }
 };
@@ -86,7 +85,7 @@ struct ConstApplyer<void, T, ARGS...>
 {
     static int Apply(lua_State *L, typename Traits<T>::RawType *value, void (T::*m)(ARGS...) const, ARGS... args)
     {
-        (value->*m)(args...);
+        (value->*m)(std::forward<ARGS>(args)...);
         return 0;
     }
 };
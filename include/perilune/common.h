@@ -8,8 +8,13 @@ extern "C"
 }
 
 #include <assert.h>
+#include <stdint.h>
+#include <atomic>
 #include <exception>
 #include <functional>
+#include <memory>
+#include <type_traits>
+#include "stats.h"
 
 namespace perilune
 {
@@ -63,7 +68,7 @@ struct Traits
 
     static RawType *GetSelf(lua_State *L, int index)
     {
-        auto p = LuaCheckUserData<T>(L, index);
+        auto p = LuaToRaw<RawType>(L, index);
         if (!p)
         {
             throw std::exception("userdata has not valid metatable");
@@ -75,11 +80,19 @@ struct Traits
     {
         auto self = GetSelf(L, 1);
         self->~T();
+        StatsOnGc<T>(L, 1);
         return 0;
     }
 
     static void SetPlacementDelete(lua_State *L, int index)
     {
+#ifndef PERILUNE_STATS
+        if constexpr (std::is_trivially_destructible<T>::value)
+        {
+            // no finalizer. a userdata with __gc costs a finalizer call per object
+            return;
+        }
+#endif
         lua_pushcfunction(L, &Destruct);
         lua_setfield(L, index, "__gc");
     }
@@ -95,17 +108,29 @@ struct Traits<T *>
 
     static RawType *GetSelf(lua_State *L, int index)
     {
-        auto pt = LuaCheckUserData<PT>(L, index);
-        if (!pt)
+        auto p = LuaToRaw<RawType>(L, index);
+        if (!p)
         {
             throw std::exception("userdata has not valid metatable");
         }
-        return *pt;
+        return p;
     }
 
+#ifdef PERILUNE_STATS
+    static int Destruct(lua_State *L)
+    {
+        // the object is not owned. count only
+        StatsOnGc<PT>(L, 1);
+        return 0;
+    }
+#endif
+
     static void SetPlacementDelete(lua_State *L, int index)
     {
-        // do nothing
+#ifdef PERILUNE_STATS
+        lua_pushcfunction(L, &Destruct);
+        lua_setfield(L, index, "__gc");
+#endif
     }
 };
 
@@ -119,12 +144,12 @@ struct Traits<std::shared_ptr<T>>
 
     static RawType *GetSelf(lua_State *L, int index)
     {
-        auto pt = LuaCheckUserData<PT>(L, index);
-        if (!pt || !pt->get())
+        auto p = LuaToRaw<RawType>(L, index);
+        if (!p)
         {
             throw std::exception("userdata has not valid metatable");
         }
-        return pt->get();
+        return p;
     }
 
     static int Destruct(lua_State *L)
@@ -134,6 +159,7 @@ struct Traits<std::shared_ptr<T>>
         {
             pt->~PT();
         }
+        StatsOnGc<PT>(L, 1);
         return 0;
     }
 
@@ -167,8 +193,8 @@ auto pop_front(const Tuple &tuple)
 template <typename T>
 int LuaGetMetatable(lua_State *L)
 {
-    lua_pushinteger(L, typeid(T).hash_code());
-    return lua_gettable(L, LUA_REGISTRYINDEX);
+    // registry has no metatable
+    return lua_rawgeti(L, LUA_REGISTRYINDEX, typeid(T).hash_code());
 }
 
 template <typename T>
@@ -187,9 +213,115 @@ int LuaNewMetatable(lua_State *L)
     return 1;
 }
 
+// how the userdata holds the object
+enum class UserDataHolder : uint16_t
+{
+    Value = 1,
+    Pointer,
+    SharedPtr,
+};
+
+template <typename T>
+struct HolderTraits
+{
+    using RawType = T;
+    static const UserDataHolder Holder = UserDataHolder::Value;
+};
+
+template <typename T>
+struct HolderTraits<T *>
+{
+    using RawType = T;
+    static const UserDataHolder Holder = UserDataHolder::Pointer;
+};
+
+template <typename T>
+struct HolderTraits<std::shared_ptr<T>>
+{
+    using RawType = T;
+    static const UserDataHolder Holder = UserDataHolder::SharedPtr;
+};
+
+///
+/// head of the userdata created by perilune.
+/// type check is an integer compare instead of the metatable lookup.
+/// the 64 bit magic keeps foreign userdata from passing as perilune userdata
+///
+struct UserDataHeader
+{
+    uint64_t Magic;
+    UserDataHolder Holder;
+    // TypeId of RawType
+    uint32_t TypeId;
+};
+
+const uint64_t USERDATA_MAGIC = 0x454e554c49524550ull; // "PERILUNE" in little endian
+
+inline uint32_t NextTypeId()
+{
+    static std::atomic<uint32_t> s_next{0};
+    return ++s_next;
+}
+
+template <typename T>
+uint32_t TypeIdNoCV()
+{
+    static const uint32_t s_id = NextTypeId();
+    return s_id;
+}
+
+// dense id per type. 0 is not used
+template <typename T>
+uint32_t TypeId()
+{
+    return TypeIdNoCV<typename std::remove_cv<T>::type>();
+}
+
+// T is placed after the header
+template <typename T>
+constexpr size_t UserDataOffset()
+{
+    return (sizeof(UserDataHeader) + alignof(T) - 1) / alignof(T) * alignof(T);
+}
+
+// push new userdata with the header. returns uninitialized storage for T
+template <typename T>
+T *LuaNewUserData(lua_State *L)
+{
+    using U = typename std::remove_cv<T>::type;
+    auto p = static_cast<char *>(lua_newuserdata(L, UserDataOffset<U>() + sizeof(U)));
+    auto header = reinterpret_cast<UserDataHeader *>(p);
+    header->Magic = USERDATA_MAGIC;
+    header->Holder = HolderTraits<U>::Holder;
+    header->TypeId = TypeId<typename HolderTraits<U>::RawType>();
+    return reinterpret_cast<T *>(p + UserDataOffset<U>());
+}
+
 template <typename T>
 T *LuaCheckUserData(lua_State *L, int ud)
 {
+    using U = typename std::remove_cv<T>::type;
+    auto p = static_cast<char *>(lua_touserdata(L, ud));
+    if (!p)
+    {
+        return nullptr;
+    }
+
+    // lightuserdata is 0
+    if (lua_rawlen(L, ud) >= sizeof(UserDataHeader))
+    {
+        auto header = reinterpret_cast<const UserDataHeader *>(p);
+        if (header->Magic == USERDATA_MAGIC)
+        {
+            if (header->Holder != HolderTraits<U>::Holder || header->TypeId != TypeId<typename HolderTraits<U>::RawType>())
+            {
+                return nullptr;
+            }
+            return reinterpret_cast<T *>(p + UserDataOffset<U>());
+        }
+    }
+
+    // foreign userdata
     if (lua_getmetatable(L, ud))
     { /* does it have a metatable? */
         LuaGetMetatable<T>(L);
@@ -211,4 +343,52 @@ T *LuaCheckUserData(lua_State *L, int ud)
     }
 }
 
+// R* from the userdata that holds R by value, pointer or shared_ptr
+template <typename R>
+R *LuaToRaw(lua_State *L, int index)
+{
+    auto p = static_cast<char *>(lua_touserdata(L, index));
+    if (!p)
+    {
+        return nullptr;
+    }
+
+    if (lua_rawlen(L, index) >= sizeof(UserDataHeader))
+    {
+        auto header = reinterpret_cast<const UserDataHeader *>(p);
+        if (header->Magic == USERDATA_MAGIC)
+        {
+            if (header->TypeId != TypeId<R>())
+            {
+                return nullptr;
+            }
+            switch (header->Holder)
+            {
+            case UserDataHolder::Value:
+                return reinterpret_cast<R *>(p + UserDataOffset<R>());
+            case UserDataHolder::Pointer:
+                return *reinterpret_cast<R **>(p + UserDataOffset<R *>());
+            case UserDataHolder::SharedPtr:
+                return reinterpret_cast<std::shared_ptr<R> *>(p + UserDataOffset<std::shared_ptr<R>>())->get();
+            }
+            return nullptr;
+        }
+    }
+
+    // foreign userdata
+    if (auto value = LuaCheckUserData<R>(L, index))
+    {
+        return value;
+    }
+    if (auto pointer = LuaCheckUserData<R *>(L, index))
+    {
+        return *pointer;
+    }
+    if (auto shared = LuaCheckUserData<std::shared_ptr<R>>(L, index))
+    {
+        return shared->get();
+    }
+    return nullptr;
+}
+
 } // namespace perilune
\ No newline at end of file
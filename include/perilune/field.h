@@ -0,0 +1,350 @@
+#pragma once
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include "common.h"
+
+namespace perilune
+{
+
+///
+/// R C::* stored without the type. any inheritance model fits
+///
+struct FieldMember
+{
+    alignas(void *) unsigned char Bytes[32];
+
+    template <typename C, typename R>
+    static FieldMember From(R C::*f)
+    {
+        static_assert(sizeof(f) <= sizeof(Bytes), "member pointer too large");
+        FieldMember member{};
+        memcpy(member.Bytes, &f, sizeof(f));
+        return member;
+    }
+
+    template <typename C, typename R>
+    R C::*To() const
+    {
+        R C::*f;
+        memcpy(&f, Bytes, sizeof(f));
+        return f;
+    }
+};
+
+// declaration order of a member field. the byte offset for standard layout T,
+// SIZE_MAX (registration order) for others
+template <typename T, typename C, typename R>
+size_t FieldOrder(R C::*f)
+{
+    if constexpr (std::is_standard_layout<T>::value)
+    {
+        // offsetof. T is never constructed
+        union Probe
+        {
+            char Dummy;
+            T Value;
+            Probe() : Dummy() {}
+            ~Probe() {}
+        };
+        static Probe s_probe;
+        auto &value = s_probe.Value;
+        return reinterpret_cast<const char *>(&(value.*f)) - reinterpret_cast<const char *>(&value);
+    }
+    else
+    {
+        return SIZE_MAX;
+    }
+}
+
+template <typename T, typename C, typename R>
+int FieldPush(lua_State *L, const void *self, const FieldMember &member)
+{
+    return LuaPush<R>::Push(L, static_cast<const T *>(self)->*member.To<C, R>());
+}
+
+template <typename T, typename C, typename R>
+void FieldSet(lua_State *L, void *self, const FieldMember &member, int index)
+{
+    static_cast<T *>(self)->*member.To<C, R>() = LuaGet<R>::Get(L, index);
+}
+
+///
+/// read member field by the member pointer. no std::function
+///
+struct FieldGetter
+{
+    FieldMember Member;
+    int (*Push)(lua_State *L, const void *self, const FieldMember &member) = nullptr;
+
+    template <typename T, typename C, typename R>
+    static FieldGetter Create(R C::*f)
+    {
+        return FieldGetter{FieldMember::From(f), &FieldPush<T, C, R>};
+    }
+
+    int Get(lua_State *L, const void *self) const
+    {
+        return Push(L, self, Member);
+    }
+};
+
+///
+/// write member field by the member pointer. no std::function
+///
+struct FieldSetter
+{
+    FieldMember Member;
+    void (*Write)(lua_State *L, void *self, const FieldMember &member, int index) = nullptr;
+
+    template <typename T, typename C, typename R>
+    static FieldSetter Create(R C::*f)
+    {
+        return FieldSetter{FieldMember::From(f), &FieldSet<T, C, R>};
+    }
+
+    void Set(lua_State *L, void *self, int index) const
+    {
+        Write(L, self, Member, index);
+    }
+};
+
+// small struct that may be passed as consecutive numbers
+template <typename T>
+constexpr bool IsScalarsCandidate = std::is_class<T>::value &&
+                                    std::is_trivially_copyable<T>::value &&
+                                    std::is_default_constructible<T>::value;
+
+///
+/// T is pushed as the numbers of its fields in the lua_State.
+/// set by UserType<T>::ReturnAsScalars at LuaNewType
+///
+template <typename T>
+struct LuaScalars
+{
+    static bool Is(lua_State *L)
+    {
+        if (!s_used)
+        {
+            // no registry lookup for the types never set
+            return false;
+        }
+        auto t = lua_rawgetp(L, LUA_REGISTRYINDEX, &s_key);
+        lua_pop(L, 1);
+        return t != LUA_TNIL;
+    }
+
+    static void Set(lua_State *L)
+    {
+        s_used = true;
+        lua_pushboolean(L, 1);
+        lua_rawsetp(L, LUA_REGISTRYINDEX, &s_key);
+    }
+
+private:
+    // registry key
+    static inline char s_key;
+    // Set in any lua_State
+    static inline bool s_used = false;
+};
+
+///
+/// member fields of T registered by Getter / Setter.
+/// converts T to and from a table
+///
+template <typename T>
+class StructFields
+{
+    struct Field
+    {
+        std::string Name;
+        FieldGetter Getter;
+        FieldSetter Setter;
+        bool IsNumber;
+        // FieldOrder
+        size_t Order;
+    };
+    // sorted by Order. same as the positional order {1, 2, 3}
+    std::vector<Field> m_fields;
+
+    StructFields() = default;
+
+public:
+    StructFields(const StructFields &) = delete;
+    StructFields &operator=(const StructFields &) = delete;
+
+    static StructFields &Instance()
+    {
+        static StructFields s_instance;
+        return s_instance;
+    }
+
+    bool empty() const
+    {
+        return m_fields.empty();
+    }
+
+    size_t size() const
+    {
+        return m_fields.size();
+    }
+
+    template <typename C, typename R>
+    void Add(const char *name, R C::*f)
+    {
+        for (auto &field : m_fields)
+        {
+            if (field.Name == name)
+            {
+                return;
+            }
+        }
+
+        Field field{name, FieldGetter::Create<T>(f), {}, std::is_arithmetic<R>::value, FieldOrder<T>(f)};
+        if constexpr (!std::is_const<R>::value)
+        {
+            field.Setter = FieldSetter::Create<T>(f);
+        }
+        auto it = std::upper_bound(m_fields.begin(), m_fields.end(), field.Order,
+                                   [](size_t order, const Field &f) { return order < f.Order; });
+        m_fields.insert(it, field);
+    }
+
+    // throw if T can not be pushed as the numbers of fields
+    void CheckScalars() const
+    {
+        if (m_fields.empty())
+        {
+            throw std::exception("no fields for scalars");
+        }
+        for (auto &field : m_fields)
+        {
+            if (!field.IsNumber || !field.Setter.Write)
+            {
+                throw std::exception("scalars require writable number fields");
+            }
+        }
+    }
+
+    // x, y, z
+    int PushScalars(lua_State *L, const T &value) const
+    {
+        luaL_checkstack(L, static_cast<int>(m_fields.size()), "too many fields");
+        for (auto &field : m_fields)
+        {
+            field.Getter.Get(L, &value);
+        }
+        return static_cast<int>(m_fields.size());
+    }
+
+    // stack#index, index + 1...
+    T GetScalars(lua_State *L, int index) const
+    {
+        T value{};
+        for (size_t i = 0; i < m_fields.size(); ++i)
+        {
+            m_fields[i].Setter.Set(L, &value, index + static_cast<int>(i));
+        }
+        return value;
+    }
+
+    // {1, 2, 3} or {x = 1, y = 2, z = 3}. missing fields keep the default
+    T Get(lua_State *L, int index) const
+    {
+        if (index < 0)
+        {
+            index = lua_absindex(L, index);
+        }
+        T value{};
+        if (m_fields.empty())
+        {
+            return value;
+        }
+        // each field value stays on the stack until the end
+        luaL_checkstack(L, static_cast<int>(m_fields.size()) + 2, "too many fields");
+        auto top = lua_gettop(L);
+
+        // table[1] decides positional or named
+        if (lua_rawgeti(L, index, 1) != LUA_TNIL)
+        {
+            SetField(L, m_fields[0], &value);
+            for (size_t i = 1; i < m_fields.size(); ++i)
+            {
+                if (lua_rawgeti(L, index, static_cast<lua_Integer>(i + 1)) != LUA_TNIL)
+                {
+                    SetField(L, m_fields[i], &value);
+                }
+            }
+        }
+        else
+        {
+            // raw access. no __index
+            auto keys = PushKeys(L);
+            for (size_t i = 0; i < m_fields.size(); ++i)
+            {
+                lua_rawgeti(L, keys, static_cast<lua_Integer>(i + 1));
+                if (lua_rawget(L, index) != LUA_TNIL)
+                {
+                    SetField(L, m_fields[i], &value);
+                }
+            }
+        }
+        lua_settop(L, top);
+        return value;
+    }
+
+    // {x = 1, y = 2, z = 3}
+    int Push(lua_State *L, const T &value) const
+    {
+        luaL_checkstack(L, 4, "too many fields");
+        auto keys = PushKeys(L);
+        lua_createtable(L, 0, static_cast<int>(m_fields.size()));
+        for (size_t i = 0; i < m_fields.size(); ++i)
+        {
+            lua_rawgeti(L, keys, static_cast<lua_Integer>(i + 1));
+            if (m_fields[i].Getter.Get(L, &value) != 1)
+            {
+                lua_settop(L, keys + 1);
+                continue;
+            }
+            lua_rawset(L, -3);
+        }
+        lua_remove(L, keys);
+        return 1;
+    }
+
+private:
+    // { names... } in the registry of L.
+    // the names are interned in each lua_State once. returns the stack index
+    int PushKeys(lua_State *L) const
+    {
+        // fields are only added. the length tells the cache is current
+        if (lua_rawgetp(L, LUA_REGISTRYINDEX, this) == LUA_TTABLE && lua_rawlen(L, -1) == m_fields.size())
+        {
+            return lua_gettop(L);
+        }
+        lua_pop(L, 1);
+
+        lua_createtable(L, static_cast<int>(m_fields.size()), 0);
+        for (size_t i = 0; i < m_fields.size(); ++i)
+        {
+            lua_pushlstring(L, m_fields[i].Name.data(), m_fields[i].Name.size());
+            lua_rawseti(L, -2, static_cast<lua_Integer>(i + 1));
+        }
+        lua_pushvalue(L, -1);
+        lua_rawsetp(L, LUA_REGISTRYINDEX, this);
+        return lua_gettop(L);
+    }
+
+    static void SetField(lua_State *L, const Field &field, T *value)
+    {
+        if (field.Setter.Write)
+        {
+            field.Setter.Set(L, value, -1);
+        }
+    }
+};
+
+} // namespace perilune
@@ -0,0 +1,194 @@
+#pragma once
+#include <stdint.h>
+#include <algorithm>
+#include <chrono>
+#include "common.h"
+
+namespace perilune
+{
+
+enum class GcMode
+{
+    Incremental,
+    Generational,
+};
+
+struct GcBudgetOptions
+{
+    GcMode Mode = GcMode::Incremental;
+    // time for the steps of a frame
+    uint32_t BudgetMicroseconds = 1000;
+    // work per frame relative to the allocation of the frame. > 1 to finish the cycles
+    double Pace = 2.0;
+    // LUA_GCSTEP size range
+    int MinStepKB = 1;
+    int MaxStepKB = 1024;
+    // slices per frame the step size aims at
+    int SlicesPerFrame = 4;
+};
+
+///
+/// gc of a frame
+///
+struct GcFrameStats
+{
+    double Microseconds = 0;
+    int Steps = 0;
+    int StepKB = 0;
+    // heap growth since the end of the last Step
+    int AllocatedKB = 0;
+    // heap after the steps
+    int HeapKB = 0;
+    // cycles finished in the frame
+    int Cycles = 0;
+    // stopped by the budget before the work was done
+    bool OverBudget = false;
+};
+
+///
+/// the collector of L runs only in Step, in slices of lua_gc(LUA_GCSTEP) at a frame boundary.
+/// the step size follows the allocation rate, and the steps stop when the frame's work is done
+/// or the time budget is used up.
+/// the previous mode and the automatic collector are restored by the destructor. destroy before lua_close
+///
+class GcBudget
+{
+    using Clock = std::chrono::steady_clock;
+
+    lua_State *m_L;
+    GcBudgetOptions m_options;
+    // LUA_GCGEN or LUA_GCINC before this
+    int m_previousMode;
+    int m_stepKB;
+    // KB per frame. moving average
+    double m_rateKB = 0;
+    int m_lastHeapKB;
+    GcFrameStats m_frame;
+    double m_maxMicroseconds = 0;
+    uint64_t m_frames = 0;
+
+    static int HeapKB(lua_State *L)
+    {
+        return lua_gc(L, LUA_GCCOUNT, 0);
+    }
+
+public:
+    GcBudget(lua_State *L, const GcBudgetOptions &options = {})
+        : m_L(L), m_options(options), m_stepKB(options.MinStepKB)
+    {
+        if (m_options.Mode == GcMode::Generational)
+        {
+            m_previousMode = lua_gc(m_L, LUA_GCGEN, 0, 0);
+        }
+        else
+        {
+            m_previousMode = lua_gc(m_L, LUA_GCINC, 0, 0, 0);
+        }
+        // LUA_GCSTEP runs while stopped
+        lua_gc(m_L, LUA_GCSTOP, 0);
+        m_lastHeapKB = HeapKB(m_L);
+    }
+
+    ~GcBudget()
+    {
+        // 0 keeps the parameters
+        if (m_previousMode == LUA_GCGEN)
+        {
+            lua_gc(m_L, LUA_GCGEN, 0, 0);
+        }
+        else
+        {
+            lua_gc(m_L, LUA_GCINC, 0, 0, 0);
+        }
+        lua_gc(m_L, LUA_GCRESTART, 0);
+    }
+
+    GcBudget(const GcBudget &) = delete;
+    GcBudget &operator=(const GcBudget &) = delete;
+
+    // call once a frame
+    const GcFrameStats &Step()
+    {
+        auto start = Clock::now();
+        auto budget = std::chrono::microseconds(m_options.BudgetMicroseconds);
+
+        m_frame = {};
+        auto heapKB = HeapKB(m_L);
+        m_frame.AllocatedKB = std::max(0, heapKB - m_lastHeapKB);
+        m_rateKB = m_frames ? m_rateKB * 0.75 + m_frame.AllocatedKB * 0.25 : m_frame.AllocatedKB;
+
+        // a few slices cover the allocation of a frame
+        auto stepKB = static_cast<int>(m_rateKB / m_options.SlicesPerFrame) + 1;
+        m_stepKB = std::min(std::max(stepKB, m_options.MinStepKB), m_options.MaxStepKB);
+        m_frame.StepKB = m_stepKB;
+
+        auto workKB = std::max(m_rateKB, static_cast<double>(m_frame.AllocatedKB)) * m_options.Pace;
+        double doneKB = 0;
+        auto slice = Clock::duration::zero();
+        while (true)
+        {
+            auto elapsed = Clock::now() - start;
+            if (m_frame.Steps && elapsed + slice > budget)
+            {
+                // the next slice would not fit. at least one slice a frame
+                m_frame.OverBudget = doneKB < workKB;
+                break;
+            }
+
+            auto sliceStart = Clock::now();
+            auto finished = lua_gc(m_L, LUA_GCSTEP, m_stepKB);
+            slice = Clock::now() - sliceStart;
+            ++m_frame.Steps;
+            doneKB += m_stepKB;
+            if (finished)
+            {
+                ++m_frame.Cycles;
+                // a new cycle starts with the next step
+                break;
+            }
+            if (m_options.Mode == GcMode::Generational)
+            {
+                // a step is a young collection
+                break;
+            }
+            if (doneKB >= workKB)
+            {
+                break;
+            }
+        }
+
+        m_lastHeapKB = HeapKB(m_L);
+        m_frame.HeapKB = m_lastHeapKB;
+        m_frame.Microseconds = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+        m_maxMicroseconds = std::max(m_maxMicroseconds, m_frame.Microseconds);
+        ++m_frames;
+        return m_frame;
+    }
+
+    // the last Step
+    const GcFrameStats &Frame() const
+    {
+        return m_frame;
+    }
+
+    double MaxMicroseconds() const
+    {
+        return m_maxMicroseconds;
+    }
+
+    uint64_t Frames() const
+    {
+        return m_frames;
+    }
+
+    // for lua. upvalue #1 is the GcBudget. returns microseconds
+    static int LuaStep(lua_State *L)
+    {
+        auto self = static_cast<GcBudget *>(lua_touserdata(L, lua_upvalueindex(1)));
+        auto &frame = self->Step();
+        lua_pushnumber(L, frame.Microseconds);
+        return 1;
+    }
+};
+
+} // namespace perilune
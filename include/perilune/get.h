@@ -1,20 +1,47 @@
 #pragma once
+#include <array>
+#include <optional>
 #include <sstream>
+#include <string_view>
+#include <vector>
 #include "common.h"
+#include "field.h"
 #include "string_win32.h"
 
 namespace perilune
 {
 
+// by the member fields registered with Getter / Setter
 template <typename T>
 struct LuaTable
 {
     static T Get(lua_State *L, int index)
     {
+        auto &fields = StructFields<T>::Instance();
+        if constexpr (std::is_default_constructible<T>::value)
+        {
+            if (!fields.empty())
+            {
+                return fields.Get(L, index);
+            }
+        }
+
         std::stringstream ss;
         ss << "LuaTable<" << typeid(T).name() << "> is not implemented";
         throw std::exception(ss.str().c_str());
     }
+
+    static int Push(lua_State *L, const T &value)
+    {
+        auto &fields = StructFields<T>::Instance();
+        if (fields.empty())
+        {
+            std::stringstream ss;
+            ss << "LuaTable<" << typeid(T).name() << "> is not implemented";
+            throw std::exception(ss.str().c_str());
+        }
+        return fields.Push(L, value);
+    }
 };
 
 template <typename T>
@@ -25,7 +52,12 @@ struct LuaGet
         auto t = lua_type(L, index);
         if (t == LUA_TUSERDATA)
         {
-            return *LuaCheckUserData<T>(L, index);
+            auto p = LuaToRaw<T>(L, index);
+            if (!p)
+            {
+                throw std::exception("invalid value");
+            }
+            return *p;
         }
         else if (t == LUA_TTABLE)
         {
@@ -33,6 +65,14 @@ struct LuaGet
         }
         else
         {
+            if constexpr (IsScalarsCandidate<T>)
+            {
+                // x, y, z
+                if (t == LUA_TNUMBER && LuaScalars<T>::Is(L))
+                {
+                    return StructFields<T>::Instance().GetScalars(L, index);
+                }
+            }
             std::stringstream ss;
             ss << "LuaGet<" << typeid(T).name() << "> is " << lua_typename(L, t);
             throw std::exception(ss.str().c_str());
@@ -48,18 +88,13 @@ struct LuaGet<T *>
         auto t = lua_type(L, index);
         if (t == LUA_TUSERDATA)
         {
-            auto p = LuaCheckUserData<T>(L, index);
+            // value, pointer or shared_ptr
+            auto p = LuaToRaw<T>(L, index);
             if (p)
             {
                 return p;
             }
 
-            auto pp = LuaCheckUserData<T *>(L, index);
-            if (pp)
-            {
-                return *pp;
-            }
-
             throw std::exception("invalid value");
         }
         else if (t == LUA_TLIGHTUSERDATA)
@@ -85,18 +120,13 @@ struct LuaGet<T &>
         auto t = lua_type(L, index);
         if (t == LUA_TUSERDATA)
         {
-            auto p = LuaCheckUserData<T>(L, index);
+            // value, pointer or shared_ptr
+            auto p = LuaToRaw<T>(L, index);
             if (p)
             {
                 return *p;
             }
 
-            auto pp = LuaCheckUserData<T *>(L, index);
-            if (pp)
-            {
-                return **pp;
-            }
-
             throw std::exception("invalid value");
         }
         else if (t == LUA_TLIGHTUSERDATA)
@@ -153,15 +183,31 @@ struct LuaGet<std::string>
 {
     static std::string Get(lua_State *L, int index)
     {
-        auto str = luaL_checkstring(L, index);
-        if (str)
-        {
-            return std::string(str);
-        }
-        else
-        {
-            return "";
-        }
+        size_t len;
+        auto str = luaL_checklstring(L, index, &len);
+        return std::string(str, len);
+    }
+};
+
+// points the lua string. valid while the string is on the stack
+template <>
+struct LuaGet<std::string_view>
+{
+    static std::string_view Get(lua_State *L, int index)
+    {
+        size_t len;
+        auto str = luaL_checklstring(L, index, &len);
+        return std::string_view(str, len);
+    }
+};
+
+// points the lua string. valid while the string is on the stack
+template <>
+struct LuaGet<const char *>
+{
+    static const char *Get(lua_State *L, int index)
+    {
+        return luaL_checkstring(L, index);
     }
 };
 
@@ -170,8 +216,9 @@ struct LuaGet<std::wstring>
 {
     static std::wstring Get(lua_State *L, int index)
     {
-        auto str = luaL_checkstring(L, index);
-        return utf8_to_wstring(str);
+        size_t len;
+        auto str = luaL_checklstring(L, index, &len);
+        return utf8_to_wstring(std::string(str, len));
     }
 };
 
@@ -180,78 +227,269 @@ struct LuaGet<std::tuple<ARGS...>>
 {
     static std::tuple<ARGS...> Get(lua_State *L, int index)
     {
-        return LuaTableToTuple<ARGS...>(L, index, 1);
+        return LuaTableToTuple<ARGS...>(L, index);
+    }
+};
+
+#pragma region LuaArg
+///
+/// storage for a function argument read from the lua stack.
+/// value parameter holds the value.
+/// reference parameter points into the userdata, or holds the value converted from a table.
+///
+template <typename A>
+struct LuaArg
+{
+    using Type = typename remove_const_ref<A>::type;
+
+    Type Value;
+
+    LuaArg(lua_State *L, int index)
+        : Value(LuaGet<Type>::Get(L, index))
+    {
+    }
+
+    Type &&Get()
+    {
+        return std::move(Value);
+    }
+};
+
+template <typename A>
+struct LuaArgRef
+{
+    A *Pointer = nullptr;
+    std::optional<A> Storage;
+
+    LuaArgRef(lua_State *L, int index)
+    {
+        auto t = lua_type(L, index);
+        if (t == LUA_TUSERDATA)
+        {
+            // value, pointer or shared_ptr
+            Pointer = LuaToRaw<A>(L, index);
+        }
+        else if (t == LUA_TLIGHTUSERDATA)
+        {
+            Pointer = (A *)lua_touserdata(L, index);
+        }
+        if (!Pointer)
+        {
+            Storage.emplace(LuaGet<A>::Get(L, index));
+        }
+    }
+
+    // Storage may be moved
+    A &Get()
+    {
+        return Pointer ? *Pointer : *Storage;
     }
 };
 
-#pragma region LuaArgsToTuple
-inline std::tuple<> LuaArgsToTuple(lua_State *L, int index, std::tuple<> *)
+template <typename A>
+struct LuaArg<const A &> : LuaArgRef<A>
 {
-    return std::tuple<>();
+    using LuaArgRef<A>::LuaArgRef;
+};
+
+template <typename A>
+struct LuaArg<A &> : LuaArgRef<A>
+{
+    using LuaArgRef<A>::LuaArgRef;
+};
+
+// I makes each leaf a distinct base
+template <std::size_t I, typename A>
+struct LuaArgLeaf
+{
+    LuaArg<A> Arg;
+};
+
+///
+/// all arguments of a call. an aggregate of leaves, no recursion and no tuple_cat.
+///
+template <typename IS, typename... ARGS>
+struct LuaArgPack;
+
+template <std::size_t... IS, typename... ARGS>
+struct LuaArgPack<std::index_sequence<IS...>, ARGS...> : LuaArgLeaf<IS, ARGS>...
+{
+    // f(head..., args...)
+    template <typename F, typename... HEAD>
+    decltype(auto) Apply(const F &f, HEAD... head)
+    {
+        return f(head..., static_cast<LuaArgLeaf<IS, ARGS> &>(*this).Arg.Get()...);
+    }
+};
+
+template <typename... ARGS>
+using LuaArgsType = LuaArgPack<std::index_sequence_for<ARGS...>, ARGS...>;
+
+template <std::size_t I, typename A>
+LuaArg<A> &LuaArgAt(LuaArgLeaf<I, A> &leaf)
+{
+    return leaf.Arg;
 }
 
-template <typename A, typename... ARGS>
-std::tuple<A, ARGS...> LuaArgsToTuple(lua_State *L, int index, std::tuple<A, ARGS...> *)
+// stack index of the argument and advance cursor.
+// a scalars type passed as numbers takes one slot per field
+template <typename A>
+int LuaArgIndex(lua_State *L, int &cursor)
 {
-    auto t = std::tuple<A>(LuaGet<A>::Get(L, index));
-    return std::tuple_cat(std::move(t),
-                          LuaArgsToTuple<ARGS...>(L, index + 1));
+    using Type = typename remove_const_ref<A>::type;
+    auto index = cursor;
+    if constexpr (IsScalarsCandidate<Type>)
+    {
+        // a number for T is an error unless LuaScalars. LuaGet checks it
+        auto &fields = StructFields<Type>::Instance();
+        if (!fields.empty() && lua_type(L, index) == LUA_TNUMBER)
+        {
+            cursor += static_cast<int>(fields.size());
+            return index;
+        }
+    }
+    ++cursor;
+    return index;
 }
 
+template <typename... ARGS, std::size_t... IS>
+LuaArgsType<ARGS...> _LuaArgs(lua_State *L, int index, std::index_sequence<IS...>)
+{
+    // each LuaArg is constructed in place.
+    // braced init list is evaluated from left to right
+    auto cursor = index;
+    return LuaArgsType<ARGS...>{{LuaArg<ARGS>(L, LuaArgIndex<ARGS>(L, cursor))}...};
+}
+
+// arguments from stack#index
 template <typename... ARGS>
-std::tuple<ARGS...> LuaArgsToTuple(lua_State *L, int index)
+LuaArgsType<ARGS...> LuaArgs(lua_State *L, int index)
 {
-    std::tuple<ARGS...> *p = nullptr;
-    return LuaArgsToTuple(L, index, p);
+    return _LuaArgs<ARGS...>(L, index, std::index_sequence_for<ARGS...>());
 }
 
+// drop A0. A0 is self
+template <typename A0, typename... ARGS>
+LuaArgsType<ARGS...> SkipFirstLuaArgs(lua_State *L, int index)
+{
+    return LuaArgs<ARGS...>(L, index);
+}
+
+// f(head..., args...)
+template <typename F, typename PACK, typename... HEAD>
+decltype(auto) LuaApply(const F &f, PACK &args, HEAD... head)
+{
+    return args.Apply(f, head...);
+}
 #pragma endregion
 
 #pragma region LuaTableToTuple
 template <typename T>
 static T LuaTableGet(lua_State *L, int tableIndex, int itemIndex)
 {
-    lua_pushinteger(L, itemIndex);
-    lua_gettable(L, tableIndex);
+    lua_geti(L, tableIndex, itemIndex);
     auto t = LuaGet<T>::Get(L, -1);
     lua_pop(L, 1);
     return t;
 }
 
-inline std::tuple<> LuaTableToTuple(lua_State *L, int index, int tableIndex, std::tuple<> *)
-{
-    return std::tuple<>();
-}
-
-template <typename A, typename... ARGS>
-std::tuple<A, ARGS...> LuaTableToTuple(lua_State *L, int index, int tableIndex, std::tuple<A, ARGS...> *)
+template <typename... ARGS, std::size_t... IS>
+std::tuple<ARGS...> _LuaTableToTuple(lua_State *L, int index, std::index_sequence<IS...>)
 {
-    A a = LuaTableGet<A>(L, index, tableIndex);
-    std::tuple<A> t = std::make_tuple(a);
-    return std::tuple_cat(std::move(t),
-                          LuaTableToTuple<ARGS...>(L, index, tableIndex + 1));
+    // braced init list is evaluated from left to right
+    return std::tuple<ARGS...>{LuaTableGet<ARGS>(L, index, static_cast<int>(IS) + 1)...};
 }
 
+// table[1], table[2]...
 template <typename... ARGS>
-std::tuple<ARGS...> LuaTableToTuple(lua_State *L, int index, int tableIndex = 1)
+std::tuple<ARGS...> LuaTableToTuple(lua_State *L, int index)
 {
-    std::tuple<ARGS...> *p = nullptr;
-    return LuaTableToTuple(L, index, tableIndex, p);
+    return _LuaTableToTuple<ARGS...>(L, lua_absindex(L, index), std::index_sequence_for<ARGS...>());
 }
 
 #pragma endregion
 
+#pragma region std::vector, std::array
+// a container element. numbers are read directly
 template <typename T>
-std::vector<T> LuaGetVector(lua_State *L, int index)
+T LuaGetElement(lua_State *L, int index)
 {
-    auto length = lua_rawlen(L, index);
-    std::vector<T> list;
-    for (int i = 1; i <= length; ++i)
+    if constexpr (std::is_same<T, bool>::value)
     {
-        auto value = perilune::LuaTableGet<std::string>(L, index, i);
-        list.push_back(value);
+        return lua_toboolean(L, index);
+    }
+    else if constexpr (std::is_integral<T>::value)
+    {
+        int isnum;
+        auto value = lua_tointegerx(L, index, &isnum);
+        if (!isnum)
+        {
+            throw std::exception("integer expected");
+        }
+        return static_cast<T>(value);
+    }
+    else if constexpr (std::is_floating_point<T>::value)
+    {
+        int isnum;
+        auto value = lua_tonumberx(L, index, &isnum);
+        if (!isnum)
+        {
+            throw std::exception("number expected");
+        }
+        return static_cast<T>(value);
+    }
+    else
+    {
+        return LuaGet<T>::Get(L, index);
     }
-    return list;
 }
 
+// table[1], table[2]... by raw access
+template <typename T>
+struct LuaTable<std::vector<T>>
+{
+    static std::vector<T> Get(lua_State *L, int index)
+    {
+        index = lua_absindex(L, index);
+        auto length = static_cast<lua_Integer>(lua_rawlen(L, index));
+        std::vector<T> list;
+        list.reserve(static_cast<size_t>(length));
+        for (lua_Integer i = 1; i <= length; ++i)
+        {
+            lua_rawgeti(L, index, i);
+            list.push_back(LuaGetElement<T>(L, -1));
+            lua_pop(L, 1);
+        }
+        return list;
+    }
+};
+
+template <typename T, std::size_t N>
+struct LuaTable<std::array<T, N>>
+{
+    static std::array<T, N> Get(lua_State *L, int index)
+    {
+        index = lua_absindex(L, index);
+        if (lua_rawlen(L, index) != N)
+        {
+            throw std::exception("table length mismatch");
+        }
+        std::array<T, N> a;
+        for (std::size_t i = 0; i < N; ++i)
+        {
+            lua_rawgeti(L, index, static_cast<lua_Integer>(i + 1));
+            a[i] = LuaGetElement<T>(L, -1);
+            lua_pop(L, 1);
+        }
+        return a;
+    }
+};
+
+template <typename T>
+std::vector<T> LuaGetVector(lua_State *L, int index)
+{
+    return LuaTable<std::vector<T>>::Get(L, index);
+}
+#pragma endregion
+
 } // namespace perilune
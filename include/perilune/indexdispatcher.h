@@ -1,6 +1,9 @@
 #pragma once
 #include "common.h"
 #include "luafunc.h"
+#include "thunk.h"
+#include "keytable.h"
+#include "field.h"
 
 namespace perilune
 {
@@ -16,43 +19,80 @@ class IndexDispatcher
     struct MetaValue
     {
         bool IsFunction = false;
+        // method: self from upvalue#2
+        // getter: self from stack#1
         LuaFunc Body;
+        // self from stack#1 for colon call
+        LuaFunc ColonBody;
+        // compile time method. self from upvalue#1
+        lua_CFunction Thunk = nullptr;
+        // compile time method. self from stack#1
+        lua_CFunction ColonThunk = nullptr;
+        // member field getter
+        FieldGetter Field;
+
+        // __newindex. stack#1: userdata, stack#3: value
+        LuaFunc Setter;
+        // member field setter
+        FieldSetter SetterField;
+
+        bool HasGetter() const
+        {
+            return IsFunction || Body || Field.Push;
+        }
+
+        bool HasSetter() const
+        {
+            return Setter || SetterField.Write;
+        }
     };
-    std::unordered_map<std::string, MetaValue> m_map;
+    KeyTable<MetaValue> m_map;
 
     // using LuaIndexGetterFunc = std::function<int(lua_State *, RawType *, lua_Integer)>;
     LuaFunc m_indexGetter;
 
+    // keep bound method closures in the user value of each userdata
+    bool m_cacheBoundMethods = false;
+
     int DispatchIndex(lua_State *L)
     {
-        auto value = perilune::Traits<T>::GetSelf(L, 1);
-        auto index = lua_tointeger(L, 2);
-
         if (m_indexGetter)
         {
+            // m_indexGetter gets self
             return m_indexGetter(L);
         }
 
-        return LuaIndexer<RawType>::Push(L, value, index);
+        auto value = perilune::Traits<T>::GetSelf(L, 1);
+        return LuaIndexer<RawType>::Push(L, value, lua_tointeger(L, 2));
     }
 
     int DispatchStringKey(lua_State *L)
     {
-        auto key = lua_tostring(L, 2);
-        auto found = m_map.find(key);
-        if (found == m_map.end())
+        size_t len;
+        auto key = lua_tolstring(L, 2, &len);
+        auto found = m_map.Find(key, len);
+        if (!found || !found->HasGetter())
         {
             lua_pushfstring(L, "'%s' is not found in __index", key);
             lua_error(L);
             return 1;
         }
 
-        if (!found->second.IsFunction)
+        return DispatchValue(L, found);
+    }
+
+    int DispatchValue(lua_State *L, MetaValue *found)
+    {
+        if (!found->IsFunction)
         {
             try
             {
-                // execute getter or setter
-                return found->second.Body(L);
+                if (found->Field.Push)
+                {
+                    return found->Field.Get(L, Traits<T>::GetSelf(L, 1));
+                }
+                // execute getter
+                return found->Body(L);
             }
             catch (const std::exception &ex)
             {
@@ -62,21 +102,174 @@ class IndexDispatcher
             }
             catch (...)
             {
-                lua_pushfstring(L, "'%s' error", key);
+                lua_pushfstring(L, "'%s' error", lua_tostring(L, 2));
                 lua_error(L);
                 return 1;
             }
         }
 
+        if (m_cacheBoundMethods)
+        {
+            return PushCachedClosure(L, found);
+        }
+
+        return PushBoundMethod(L, found);
+    }
+
+    // __index
+    // upvalue#1: IndexDispatcher
+    // upvalue#2: { [interned key] = slot }
+    // upvalue#3: method table for colon call or nil
+    static int LuaIndex(lua_State *L)
+    {
+        auto self = (IndexDispatcher *)lua_touserdata(L, lua_upvalueindex(1));
+
+        if (LuaIndexer<RawType>::IsContainer && !self->m_indexGetter && lua_isinteger(L, 2))
+        {
+            // validate self once
+            if (auto value = LuaToRaw<RawType>(L, 1))
+            {
+                return LuaIndexer<RawType>::Push(L, value, lua_tointeger(L, 2));
+            }
+        }
+
+        if (lua_type(L, 2) == LUA_TSTRING)
+        {
+            if (lua_type(L, lua_upvalueindex(3)) == LUA_TTABLE)
+            {
+                lua_pushvalue(L, 2);
+                if (lua_rawget(L, lua_upvalueindex(3)) != LUA_TNIL)
+                {
+                    return 1;
+                }
+                lua_pop(L, 1);
+            }
+
+            // short string key is compared by identity
+            lua_pushvalue(L, 2);
+            if (lua_rawget(L, lua_upvalueindex(2)) == LUA_TNUMBER)
+            {
+                auto found = &self->m_map.At(lua_tointeger(L, -1)).Value;
+                lua_pop(L, 1);
+                if (found->HasGetter())
+                {
+                    return self->DispatchValue(L, found);
+                }
+            }
+            else
+            {
+                lua_pop(L, 1);
+            }
+        }
+
+        // integer key, or error for unknown key
+        return LuaTryCall(L, [self, L]() {
+            return self->Dispatch(L);
+        });
+    }
+
+    // __newindex
+    // upvalue#1: IndexDispatcher
+    // upvalue#2: { [interned key] = slot }
+    // stack#3: value
+    static int LuaNewIndex(lua_State *L)
+    {
+        auto self = (IndexDispatcher *)lua_touserdata(L, lua_upvalueindex(1));
+
+        if (lua_isinteger(L, 2))
+        {
+            return LuaTryCall(L, [self, L]() {
+                return self->DispatchNewIndex(L);
+            });
+        }
+
+        MetaValue *found = nullptr;
+        if (lua_type(L, 2) == LUA_TSTRING)
+        {
+            lua_pushvalue(L, 2);
+            if (lua_rawget(L, lua_upvalueindex(2)) == LUA_TNUMBER)
+            {
+                found = &self->m_map.At(lua_tointeger(L, -1)).Value;
+            }
+            lua_pop(L, 1);
+        }
+
+        if (!found || !found->HasSetter())
+        {
+            lua_pushfstring(L, "'%s' is not found in __newindex", lua_tostring(L, 2));
+            lua_error(L);
+            return 1;
+        }
+
+        return LuaTryCall(L, [found, L]() {
+            if (found->SetterField.Write)
+            {
+                found->SetterField.Set(L, Traits<T>::GetSelf(L, 1), 3);
+                return 0;
+            }
+            return found->Setter(L);
+        });
+    }
+
+    // stack#1: userdata
+    // stack#2: integer key
+    // stack#3: value
+    int DispatchNewIndex(lua_State *L)
+    {
+        LuaIndexer<RawType>::Set(L, Traits<T>::GetSelf(L, 1), lua_tointeger(L, 2), 3);
+        return 0;
+    }
+
+    // stack#1: userdata
+    int PushBoundMethod(lua_State *L, MetaValue *value)
+    {
+        if (value->Thunk)
+        {
+            // upvalue#1: userdata
+            lua_pushvalue(L, 1);
+            lua_pushcclosure(L, value->Thunk, 1);
+            return 1;
+        }
+
         // upvalue#1: body
-        lua_pushlightuserdata(L, &found->second.Body);
+        lua_pushlightuserdata(L, &value->Body);
         // upvalue#2: userdata
-        lua_pushvalue(L, -3);
+        lua_pushvalue(L, 1);
         // closure
         lua_pushcclosure(L, &LuaFuncClosure, 2);
         return 1;
     }
 
+    // stack#1: userdata
+    // stack#2: key
+    // user value of stack#1: { [key] = closure }
+    int PushCachedClosure(lua_State *L, MetaValue *value)
+    {
+        if (lua_getuservalue(L, 1) != LUA_TTABLE)
+        {
+            // first method access on this userdata
+            lua_pop(L, 1);
+            lua_newtable(L);
+            lua_pushvalue(L, -1);
+            lua_setuservalue(L, 1);
+        }
+        int cache = lua_gettop(L);
+
+        lua_pushvalue(L, 2);
+        if (lua_rawget(L, cache) == LUA_TFUNCTION)
+        {
+            return 1;
+        }
+        lua_pop(L, 1);
+
+        PushBoundMethod(L, value);
+
+        lua_pushvalue(L, 2);
+        lua_pushvalue(L, -2);
+        lua_rawset(L, cache);
+        return 1;
+    }
+
 public:
     IndexDispatcher()
     {
@@ -84,6 +277,18 @@ public:
 
     ~IndexDispatcher() {}
 
+    // create a bound method closure once per (userdata, method)
+    void CacheBoundMethods(bool enable = true)
+    {
+        m_cacheBoundMethods = enable;
+    }
+
+    // after registration
+    void Seal()
+    {
+        m_map.Seal();
+    }
+
     // stack#1: userdata
     // stack#2: key
     int Dispatch(lua_State *L)
@@ -103,12 +308,136 @@ public:
         return 1;
     }
 
+    // push __index closure
+    // methodTable: stack index of the method table for colon call or 0
+    void PushLuaIndex(lua_State *L, int methodTable)
+    {
+        if (methodTable)
+        {
+            methodTable = lua_absindex(L, methodTable);
+        }
+
+        // upvalue#1
+        lua_pushlightuserdata(L, this);
+
+        // upvalue#2. intern keys to this state
+        PushKeySlots(L);
+
+        // upvalue#3
+        if (methodTable)
+        {
+            lua_pushvalue(L, methodTable);
+        }
+        else
+        {
+            lua_pushnil(L);
+        }
+
+        lua_pushcclosure(L, &LuaIndex, 3);
+    }
+
+    // push __newindex closure
+    void PushLuaNewIndex(lua_State *L)
+    {
+        // upvalue#1
+        lua_pushlightuserdata(L, this);
+        // upvalue#2
+        PushKeySlots(L);
+        lua_pushcclosure(L, &LuaNewIndex, 2);
+    }
+
+    bool HasSetter() const
+    {
+        if (LuaIndexer<RawType>::IsContainer)
+        {
+            return true;
+        }
+        for (auto &entry : m_map)
+        {
+            if (entry.Value.HasSetter())
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // { [key] = slot }
+    void PushKeySlots(lua_State *L)
+    {
+        lua_createtable(L, 0, (int)m_map.size());
+        lua_Integer slot = 0;
+        for (auto &entry : m_map)
+        {
+            lua_pushlstring(L, entry.Key.data(), entry.Key.size());
+            lua_pushinteger(L, slot++);
+            lua_rawset(L, -3);
+        }
+    }
+
+    // push { name = function(self, ...) } for colon call
+    void PushMethodTable(lua_State *L)
+    {
+        lua_newtable(L);
+        for (auto &entry : m_map)
+        {
+            if (!entry.Value.IsFunction)
+            {
+                continue;
+            }
+            if (entry.Value.ColonThunk)
+            {
+                lua_pushcfunction(L, entry.Value.ColonThunk);
+                lua_setfield(L, -2, entry.Key.c_str());
+            }
+            else if (entry.Value.ColonBody)
+            {
+                lua_pushlightuserdata(L, &entry.Value.ColonBody);
+                lua_pushcclosure(L, &LuaFuncClosure, 1);
+                lua_setfield(L, -2, entry.Key.c_str());
+            }
+        }
+    }
+
+    // method table is enough for __index
+    bool IsMethodOnly() const
+    {
+        if (m_indexGetter || LuaIndexer<RawType>::IsContainer)
+        {
+            return false;
+        }
+        for (auto &entry : m_map)
+        {
+            if (entry.Value.IsFunction)
+            {
+                if (!(entry.Value.ColonBody || entry.Value.ColonThunk))
+                {
+                    return false;
+                }
+            }
+            else if (entry.Value.HasGetter())
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void SetMethod(const char *name, const LuaFunc &lf, const LuaFunc &colon)
+    {
+        auto &value = m_map[name];
+        value.IsFunction = true;
+        value.Body = lf;
+        value.ColonBody = colon;
+    }
+
     // for member function pointer
     template <typename R, typename C, typename... ARGS>
     void Method(const char *name, R (C::*m)(ARGS...))
     {
         auto lf = MethodSelfFromUpvalue2((T *)nullptr, name, m, std::index_sequence_for<ARGS...>());
-        m_map.insert(std::make_pair(name, MetaValue{true, lf}));
+        auto colon = MethodSelfFromStack1((T *)nullptr, name, m, std::index_sequence_for<ARGS...>());
+        SetMethod(name, lf, colon);
     }
 
     // for const member function pointer
@@ -116,24 +445,76 @@ public:
     void Method(const char *name, R (C::*m)(ARGS...) const)
     {
         auto lf = ConstMethodSelfFromUpvalue2((T *)nullptr, name, m, std::index_sequence_for<ARGS...>());
-        m_map.insert(std::make_pair(name, MetaValue{true, lf}));
+        auto colon = ConstMethodSelfFromStack1((T *)nullptr, name, m, std::index_sequence_for<ARGS...>());
+        SetMethod(name, lf, colon);
     }
 
     template <typename F>
     void Method(const char *name, F f)
     {
         auto lf = LambdaMethodSelfFromUpvalue2((T *)nullptr, name, f, &decltype(f)::operator());
-        m_map.insert(std::make_pair(name, MetaValue{true, lf}));
+        auto colon = LambdaMethodSelfFromStack1((T *)nullptr, name, f, &decltype(f)::operator());
+        SetMethod(name, lf, colon);
     }
 
+    // mutate self and return self. acc.add_(v)
+    // [](RawType *self, ARGS...){}
+    template <typename F>
+    void InPlaceMethod(const char *name, F f)
+    {
+        auto lf = LambdaInPlaceSelfFromUpvalue2((T *)nullptr, name, f, &decltype(f)::operator());
+        auto colon = LambdaInPlaceSelfFromStack1((T *)nullptr, name, f, &decltype(f)::operator());
+        SetMethod(name, lf, colon);
+    }
+
+    // *self += v
+    template <typename V = RawType>
+    void InPlaceAdd(const char *name = "add_")
+    {
+        InPlaceMethod(name, [](RawType *self, const V &v) { *self += v; });
+    }
+
+    // *self -= v
+    template <typename V = RawType>
+    void InPlaceSub(const char *name = "sub_")
+    {
+        InPlaceMethod(name, [](RawType *self, const V &v) { *self -= v; });
+    }
+
+    // *self *= v
+    template <typename V = RawType>
+    void InPlaceMul(const char *name = "mul_")
+    {
+        InPlaceMethod(name, [](RawType *self, const V &v) { *self *= v; });
+    }
+
+    // *self /= v
+    template <typename V = RawType>
+    void InPlaceDiv(const char *name = "div_")
+    {
+        InPlaceMethod(name, [](RawType *self, const V &v) { *self /= v; });
+    }
+
+    // for member function pointer known at compile time
+    // d->Method<&Vector3::SqNorm>("sqnorm");
+    template <auto M>
+    void Method(const char *name)
+    {
+        auto &value = m_map[name];
+        value.IsFunction = true;
+        value.Thunk = &MethodThunk<T, M>::SelfFromUpvalue1;
+        value.ColonThunk = &MethodThunk<T, M>::SelfFromStack1;
+    }
+
+    // upvalue#2: userdata. not available as colon call
     void LuaMethod(const char *name, const LuaFunc &func)
     {
-        m_map.insert(std::make_pair(name, MetaValue{true, func}));
+        SetMethod(name, func, nullptr);
     }
 
     void LuaGetter(const char *name, const LuaFunc &lf)
     {
-        m_map.insert(std::make_pair(name, MetaValue{false, lf}));
+        m_map[name].Body = lf;
     }
 
     // for lambda
@@ -141,15 +522,37 @@ public:
     void Getter(const char *name, F f)
     {
         auto lf = LambdaGetterSelfFromStack1((T *)nullptr, name, f, &decltype(f)::operator());
-        m_map.insert(std::make_pair(name, MetaValue{false, lf}));
+        m_map[name].Body = lf;
     }
 
     // for member field pointer
     template <typename C, typename R>
     void Getter(const char *name, R C::*f)
     {
-        auto lf = FieldGetterSelfFromStack1((T *)nullptr, name, f);
-        m_map.insert(std::make_pair(name, MetaValue{false, lf}));
+        m_map[name].Field = FieldGetter::Create<RawType>(f);
+        StructFields<RawType>::Instance().Add(name, f);
+    }
+
+    // stack#1: userdata
+    // stack#3: value
+    void LuaSetter(const char *name, const LuaFunc &lf)
+    {
+        m_map[name].Setter = lf;
+    }
+
+    // for lambda. [](RawType *self, V value){}
+    template <typename F>
+    void Setter(const char *name, F f)
+    {
+        m_map[name].Setter = LambdaSetterSelfFromStack1((T *)nullptr, name, f, &decltype(f)::operator());
+    }
+
+    // for member field pointer
+    template <typename C, typename R>
+    void Setter(const char *name, R C::*f)
+    {
+        m_map[name].SetterField = FieldSetter::Create<RawType>(f);
+        StructFields<RawType>::Instance().Add(name, f);
     }
 
 private:
@@ -158,10 +561,8 @@ private:
     {
         LuaFunc callback = [f](lua_State *L) {
             auto self = perilune::Traits<T>::GetSelf(L, 1);
-            auto cdr = pop_front(LuaArgsToTuple<ARGS...>(L, 1));
-            auto args = std::tuple_cat(std::make_tuple(self), cdr);
-            R r = std::apply(f, args);
-            return LuaPush<R>::Push(L, r);
+            auto args = SkipFirstLuaArgs<ARGS...>(L, 2);
+            return LuaPushInvoke<R, true>(L, [&]() -> R { return LuaApply(f, args, self); });
         };
         LuaIndexGetter(callback);
     }
@@ -179,4 +580,4 @@ public:
     }
 };
 
-} // namespace perilune
\ No newline at end of file
+} // namespace perilune
\ No newline at end of file
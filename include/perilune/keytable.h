@@ -0,0 +1,242 @@
+#pragma once
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+#include <deque>
+#include <string>
+#include <vector>
+
+namespace perilune
+{
+
+///
+/// name to value table for __index.
+///
+/// sealed by Seal() after registration. a sealed table finds the key with a
+/// minimal perfect hash over the registered names (one slot per name),
+/// one hash, one displacement read and one compare,
+/// from (const char *, size_t) without std::string.
+///
+template <typename V>
+class KeyTable
+{
+public:
+    struct Entry
+    {
+        std::string Key;
+        V Value;
+    };
+
+private:
+    // stable address for lua_pushlightuserdata
+    std::deque<Entry> m_entries;
+
+    // minimal perfect hash (CHD, hash and displace).
+    // a key hashes to a bucket, and the displacement of the bucket places its keys in
+    // m_entries.size() slots without collision
+    std::vector<uint32_t> m_displacements;
+    // slot to entry index
+    std::vector<uint32_t> m_slots;
+    uint32_t m_seed = 0;
+    bool m_sealed = false;
+
+    // average keys per bucket
+    static const uint32_t BucketSize = 4;
+
+    // FNV-1a
+    static uint32_t Hash(uint32_t seed, const char *key, size_t len)
+    {
+        uint32_t h = 2166136261u ^ seed;
+        for (size_t i = 0; i < len; ++i)
+        {
+            h ^= (uint8_t)key[i];
+            h *= 16777619u;
+        }
+        return h;
+    }
+
+    // murmur3 finalizer
+    static uint32_t Mix(uint32_t h, uint32_t k)
+    {
+        h ^= k;
+        h ^= h >> 16;
+        h *= 0x85ebca6bu;
+        h ^= h >> 13;
+        h *= 0xc2b2ae35u;
+        h ^= h >> 16;
+        return h;
+    }
+
+    static uint32_t Bucket(uint32_t h, uint32_t buckets)
+    {
+        return Mix(h, 0x9e3779b9u) % buckets;
+    }
+
+    // displacement d = d0 * n + d1 visits all (d0, d1) pairs
+    static uint32_t Slot(uint32_t h, uint32_t d, uint32_t n)
+    {
+        auto f1 = Mix(h, 0x7f4a7c15u) % n;
+        auto f2 = Mix(h, 0x165667b1u) % n;
+        auto d0 = d / n;
+        auto d1 = d % n;
+        return static_cast<uint32_t>((f1 + static_cast<uint64_t>(d0) * f2 + d1) % n);
+    }
+
+    bool TrySeed(uint32_t seed)
+    {
+        auto n = static_cast<uint32_t>(m_entries.size());
+        auto buckets = (n + BucketSize - 1) / BucketSize;
+
+        std::vector<uint32_t> hashes(n);
+        std::vector<std::vector<uint32_t>> keys(buckets);
+        for (uint32_t i = 0; i < n; ++i)
+        {
+            auto &key = m_entries[i].Key;
+            hashes[i] = Hash(seed, key.data(), key.size());
+            keys[Bucket(hashes[i], buckets)].push_back(i);
+        }
+
+        // larger buckets first
+        std::vector<uint32_t> order(buckets);
+        for (uint32_t i = 0; i < buckets; ++i)
+        {
+            order[i] = i;
+        }
+        std::stable_sort(order.begin(), order.end(), [&keys](uint32_t l, uint32_t r) {
+            return keys[l].size() > keys[r].size();
+        });
+
+        m_displacements.assign(buckets, 0);
+        m_slots.assign(n, 0);
+        std::vector<bool> used(n);
+        std::vector<uint32_t> slots;
+        auto limit = static_cast<uint64_t>(n) * n;
+        for (auto bucket : order)
+        {
+            auto &bucketKeys = keys[bucket];
+            if (bucketKeys.empty())
+            {
+                break;
+            }
+
+            bool placed = false;
+            for (uint64_t d = 0; d < limit && !placed; ++d)
+            {
+                slots.clear();
+                placed = true;
+                for (auto i : bucketKeys)
+                {
+                    auto slot = Slot(hashes[i], static_cast<uint32_t>(d), n);
+                    if (used[slot] || std::find(slots.begin(), slots.end(), slot) != slots.end())
+                    {
+                        placed = false;
+                        break;
+                    }
+                    slots.push_back(slot);
+                }
+                if (placed)
+                {
+                    m_displacements[bucket] = static_cast<uint32_t>(d);
+                    for (size_t j = 0; j < slots.size(); ++j)
+                    {
+                        used[slots[j]] = true;
+                        m_slots[slots[j]] = bucketKeys[j];
+                    }
+                }
+            }
+            if (!placed)
+            {
+                // keys with the same hash
+                return false;
+            }
+        }
+
+        m_seed = seed;
+        return true;
+    }
+
+public:
+    using iterator = typename std::deque<Entry>::iterator;
+    using const_iterator = typename std::deque<Entry>::const_iterator;
+    iterator begin() { return m_entries.begin(); }
+    iterator end() { return m_entries.end(); }
+    const_iterator begin() const { return m_entries.begin(); }
+    const_iterator end() const { return m_entries.end(); }
+    size_t size() const { return m_entries.size(); }
+
+    // index is the insertion order
+    Entry &At(size_t index) { return m_entries[index]; }
+
+    // keep first value if key exists. same as std::unordered_map::insert
+    bool Insert(const char *key, const V &value)
+    {
+        if (Find(key, strlen(key)))
+        {
+            return false;
+        }
+        m_entries.push_back(Entry{key, value});
+        m_sealed = false;
+        return true;
+    }
+
+    // insert default value if key not exists
+    V &operator[](const char *key)
+    {
+        if (auto found = Find(key, strlen(key)))
+        {
+            return *found;
+        }
+        m_entries.push_back(Entry{key, V{}});
+        m_sealed = false;
+        return m_entries.back().Value;
+    }
+
+    void Seal()
+    {
+        if (m_sealed)
+        {
+            return;
+        }
+
+        for (uint32_t seed = 0;; ++seed)
+        {
+            if (TrySeed(seed))
+            {
+                m_sealed = true;
+                return;
+            }
+        }
+    }
+
+    V *Find(const char *key, size_t len)
+    {
+        if (!m_sealed)
+        {
+            // while registration
+            for (auto &e : m_entries)
+            {
+                if (e.Key.size() == len && memcmp(e.Key.data(), key, len) == 0)
+                {
+                    return &e.Value;
+                }
+            }
+            return nullptr;
+        }
+
+        auto n = static_cast<uint32_t>(m_slots.size());
+        if (!n)
+        {
+            return nullptr;
+        }
+        auto h = Hash(m_seed, key, len);
+        auto d = m_displacements[Bucket(h, static_cast<uint32_t>(m_displacements.size()))];
+        auto &e = m_entries[m_slots[Slot(h, d, n)]];
+        if (e.Key.size() != len || memcmp(e.Key.data(), key, len) != 0)
+        {
+            return nullptr;
+        }
+        return &e.Value;
+    }
+};
+
+} // namespace perilune
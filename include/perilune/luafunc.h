@@ -48,9 +48,8 @@ LuaFunc ToLuaFunc(const char *name,
                   std::index_sequence<IS...>)
 {
     return [f](lua_State *L) {
-        auto args = LuaArgsToTuple<ARGS...>(L, 1);
-        auto r = f(std::get<IS>(args)...);
-        return LuaPush<R>::Push(L, r);
+        auto args = LuaArgs<ARGS...>(L, 1);
+        return LuaPushInvoke<R>(L, [&]() -> R { return LuaApply(f, args); });
     };
 }
 
@@ -62,25 +61,19 @@ LuaFunc MetaMethodSelfFromStack1(T *, MetaKey key, const F &f, R (C::*m)(ARGS...
     // stack#1: userdata
     return [f](lua_State *L) {
         auto self = Traits<T>::GetSelf(L, 1);
-        auto cdr = pop_front(LuaArgsToTuple<ARGS...>(L, 1));
-        auto args = std::tuple_cat(std::make_tuple(self), cdr);
-        // auto args = LuaArgsToTuple<ARGS...>(L, 1);
-        R r = std::apply(f, args);
-        return LuaPush<R>::Push(L, r);
+        auto args = SkipFirstLuaArgs<ARGS...>(L, 2);
+        return LuaPushInvoke<R, true>(L, [&]() -> R { return LuaApply(f, args, self); });
     };
 }
 
-// void
+// void. the first argument is read by LuaGet like the others (T *, const T &, std::shared_ptr<T>...)
 template <typename T, typename F, typename C, typename... ARGS>
 LuaFunc MetaMethodSelfFromStack1(T *, MetaKey key, const F &f, void (C::*m)(ARGS...) const)
 {
     // stack#1: userdata
     return [f](lua_State *L) {
-        // auto self = Traits<T>::GetSelf(L, 1);
-        // auto cdr = pop_front(LuaArgsToTuple<ARGS...>(L, 1));
-        // auto args = std::tuple_cat(std::make_tuple(self), cdr);
-        auto args = LuaArgsToTuple<ARGS...>(L, 1);
-        std::apply(f, args);
+        auto args = LuaArgs<ARGS...>(L, 1);
+        LuaApply(f, args);
         return 0;
     };
 }
@@ -91,20 +84,71 @@ LuaFunc LambdaGetterSelfFromStack1(T *, const char *name, const F &f, R (C::*)(t
     // stack#1: userdata
     return [f](lua_State *L) {
         auto value = Traits<T>::GetSelf(L, 1);
-        R r = f(value);
-        return LuaPush<R>::Push(L, r);
+        return LuaPushInvoke<R, true>(L, [&]() -> R { return f(value); });
     };
 }
 
-// for field
-template <typename T, typename C, typename R>
-LuaFunc FieldGetterSelfFromStack1(T *, const char *name, R C::*f)
+// stack#3: value
+template <typename T, typename F, typename C, typename V>
+LuaFunc LambdaSetterSelfFromStack1(T *, const char *name, const F &f, void (C::*)(typename Traits<T>::RawType *, V) const)
 {
     // stack#1: userdata
     return [f](lua_State *L) {
         auto value = Traits<T>::GetSelf(L, 1);
-        R r = value->*f;
-        return LuaPush<R>::Push(L, r);
+        f(value, LuaGet<typename remove_const_ref<V>::type>::Get(L, 3));
+        return 0;
+    };
+}
+
+// for colon call. obj:method(...)
+template <typename T, typename R, typename C, typename... ARGS, std::size_t... IS>
+LuaFunc MethodSelfFromStack1(T *, const char *name, R (C::*m)(ARGS...), std::index_sequence<IS...>)
+{
+    using RawType = typename Traits<T>::RawType;
+
+    // stack#1: userdata
+    return [m](lua_State *L) {
+        auto value = Traits<T>::GetSelf(L, 1);
+        auto args = LuaArgs<ARGS...>(L, 2);
+        return Applyer<R, RawType, ARGS...>::Apply(L, value, m, LuaArgAt<IS>(args).Get()...);
+    };
+}
+
+template <typename T, typename R, typename C, typename... ARGS, std::size_t... IS>
+LuaFunc ConstMethodSelfFromStack1(T *, const char *name, R (C::*m)(ARGS...) const, std::index_sequence<IS...>)
+{
+    using RawType = typename Traits<T>::RawType;
+
+    // stack#1: userdata
+    return [m](lua_State *L) {
+        auto value = Traits<T>::GetSelf(L, 1);
+        auto args = LuaArgs<ARGS...>(L, 2);
+        return ConstApplyer<R, RawType, ARGS...>::Apply(L, value, m, LuaArgAt<IS>(args).Get()...);
+    };
+}
+
+template <typename T, typename F, typename R, typename C, typename... ARGS>
+LuaFunc LambdaMethodSelfFromStack1(T *, const char *name, const F &f, R (C::*)(ARGS...) const)
+{
+    // stack#1: userdata
+    return [f](lua_State *L) {
+        auto value = Traits<T>::GetSelf(L, 1);
+        auto args = SkipFirstLuaArgs<ARGS...>(L, 2);
+        return LuaPushInvoke<R>(L, [&]() -> R { return LuaApply(f, args, value); });
+    };
+}
+
+// return self. no new userdata
+template <typename T, typename F, typename C, typename... ARGS>
+LuaFunc LambdaInPlaceSelfFromStack1(T *, const char *name, const F &f, void (C::*)(ARGS...) const)
+{
+    // stack#1: userdata
+    return [f](lua_State *L) {
+        auto value = Traits<T>::GetSelf(L, 1);
+        auto args = SkipFirstLuaArgs<ARGS...>(L, 2);
+        LuaApply(f, args, value);
+        lua_pushvalue(L, 1);
+        return 1;
     };
 }
 
@@ -120,8 +164,8 @@ LuaFunc MethodSelfFromUpvalue2(T *, const char *name, R (C::*m)(ARGS...), std::i
     // upvalue#2: userdata
     return [m](lua_State *L) {
         auto value = Traits<T>::GetSelf(L, lua_upvalueindex(2));
-        auto args = LuaArgsToTuple<remove_const_ref<ARGS>::type...>(L, 1);
-        return Applyer<R, RawType, ARGS...>::Apply(L, value, m, std::get<IS>(args)...);
+        auto args = LuaArgs<ARGS...>(L, 1);
+        return Applyer<R, RawType, ARGS...>::Apply(L, value, m, LuaArgAt<IS>(args).Get()...);
     };
 }
 
@@ -133,44 +177,36 @@ LuaFunc ConstMethodSelfFromUpvalue2(T *, const char *name, R (C::*m)(ARGS...) co
     // upvalue#2: userdata
     return [m](lua_State *L) {
         auto value = Traits<T>::GetSelf(L, lua_upvalueindex(2));
-        auto args = LuaArgsToTuple<ARGS...>(L, 1);
-        return ConstApplyer<R, RawType, ARGS...>::Apply(L, value, m, std::get<IS>(args)...);
+        auto args = LuaArgs<ARGS...>(L, 1);
+        return ConstApplyer<R, RawType, ARGS...>::Apply(L, value, m, LuaArgAt<IS>(args).Get()...);
     };
 }
 
-template <typename A0, typename... ARGS>
-std::tuple<ARGS...> SkipFirstLuaArgsToTuple(lua_State *L, int index)
-{
-    return LuaArgsToTuple<ARGS...>(L, index);
-}
-
 template <typename T, typename F, typename R, typename C, typename... ARGS>
 LuaFunc LambdaMethodSelfFromUpvalue2(T *, const char *name, const F &f, R (C::*)(ARGS...) const)
 {
     // upvalue#2: userdata
     return [f](lua_State *L) {
         auto value = Traits<T>::GetSelf(L, lua_upvalueindex(2));
-        auto cdr = SkipFirstLuaArgsToTuple<ARGS...>(L, 1);
-        auto args = std::tuple_cat(std::make_tuple(value), cdr);
-        R r = std::apply(f, args);
-        return LuaPush<R>::Push(L, r);
+        auto args = SkipFirstLuaArgs<ARGS...>(L, 1);
+        return LuaPushInvoke<R>(L, [&]() -> R { return LuaApply(f, args, value); });
     };
 }
 
-// void
+// return self. no new userdata
 template <typename T, typename F, typename C, typename... ARGS>
-LuaFunc LambdaMethodSelfFromUpvalue2(T *, const char *name, const F &f, void (C::*)(ARGS...) const)
+LuaFunc LambdaInPlaceSelfFromUpvalue2(T *, const char *name, const F &f, void (C::*)(ARGS...) const)
 {
     // upvalue#2: userdata
     return [f](lua_State *L) {
         auto value = Traits<T>::GetSelf(L, lua_upvalueindex(2));
-        auto cdr = SkipFirstLuaArgsToTuple<ARGS...>(L, 1);
-        auto args = std::tuple_cat(std::make_tuple(value), cdr);
-        std::apply(f, args);
-        return 0;
+        auto args = SkipFirstLuaArgs<ARGS...>(L, 1);
+        LuaApply(f, args, value);
+        lua_pushvalue(L, lua_upvalueindex(2));
+        return 1;
     };
 }
 
 #pragma endregion
 
-} // namespace perilune
\ No newline at end of file
+} // namespace perilune
\ No newline at end of file
@@ -0,0 +1,165 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace perilune
+{
+
+///
+/// slab pool of T. freed slots are recycled before a new slab is allocated
+///
+template <typename T>
+class ObjectPool
+{
+    union Slot {
+        Slot *Next;
+        alignas(T) unsigned char Storage[sizeof(T)];
+    };
+
+    // each slab has m_slabSize slots
+    struct Slab
+    {
+        std::unique_ptr<Slot[]> Slots;
+        // a slot has a constructed T. Delete ignores a dead slot
+        std::vector<bool> Live;
+    };
+    std::vector<Slab> m_slabs;
+    // the first slot and the index of each slab. sorted by address for Find
+    std::vector<std::pair<const Slot *, size_t>> m_sorted;
+    size_t m_slabSize;
+    Slot *m_free = nullptr;
+    size_t m_live = 0;
+
+    void AddSlab()
+    {
+        auto slab = std::unique_ptr<Slot[]>(new Slot[m_slabSize]);
+        // first slot is the head
+        for (size_t i = m_slabSize; i > 0; --i)
+        {
+            slab[i - 1].Next = m_free;
+            m_free = &slab[i - 1];
+        }
+        auto entry = std::make_pair(static_cast<const Slot *>(slab.get()), m_slabs.size());
+        m_sorted.insert(std::upper_bound(m_sorted.begin(), m_sorted.end(), entry, Less), entry);
+        m_slabs.push_back({std::move(slab), std::vector<bool>(m_slabSize)});
+    }
+
+    static bool Less(const std::pair<const Slot *, size_t> &l, const std::pair<const Slot *, size_t> &r)
+    {
+        return std::less<const Slot *>()(l.first, r.first);
+    }
+
+    // p is a slot of a slab. binary search for the last slab that begins at or before p
+    bool Find(const T *p, size_t *slab, size_t *index) const
+    {
+        auto it = std::upper_bound(m_sorted.begin(), m_sorted.end(),
+                                   std::make_pair(reinterpret_cast<const Slot *>(p), size_t()), Less);
+        if (it == m_sorted.begin())
+        {
+            return false;
+        }
+        --it;
+        auto offset = reinterpret_cast<uintptr_t>(p) - reinterpret_cast<uintptr_t>(it->first);
+        if (offset >= sizeof(Slot) * m_slabSize || offset % sizeof(Slot) != 0)
+        {
+            return false;
+        }
+        *slab = it->second;
+        *index = offset / sizeof(Slot);
+        return true;
+    }
+
+
+public:
+    explicit ObjectPool(size_t capacity)
+        : m_slabSize(capacity ? capacity : 1)
+    {
+        AddSlab();
+    }
+
+    ~ObjectPool()
+    {
+        // objects still alive are not destructed. the lua_State should be closed first
+    }
+
+    ObjectPool(const ObjectPool &) = delete;
+    ObjectPool &operator=(const ObjectPool &) = delete;
+
+    template <typename... ARGS>
+    T *New(ARGS &&... args)
+    {
+        if (!m_free)
+        {
+            AddSlab();
+        }
+        auto slot = m_free;
+        m_free = slot->Next;
+        T *p;
+        try
+        {
+            p = new (slot->Storage) T(std::forward<ARGS>(args)...);
+        }
+        catch (...)
+        {
+            // the constructor may have overwritten Next
+            slot->Next = m_free;
+            m_free = slot;
+            throw;
+        }
+        size_t slab;
+        size_t index;
+        Find(p, &slab, &index);
+        m_slabs[slab].Live[index] = true;
+        ++m_live;
+        return p;
+    }
+
+    bool Contains(const T *p) const
+    {
+        size_t slab;
+        size_t index;
+        return Find(p, &slab, &index);
+    }
+
+    // p not from this pool or already deleted is ignored.
+    // the same T * pushed twice has a __gc for each userdata
+    void Delete(T *p)
+    {
+        size_t slab;
+        size_t index;
+        if (!p || !Find(p, &slab, &index) || !m_slabs[slab].Live[index])
+        {
+            return;
+        }
+        m_slabs[slab].Live[index] = false;
+        p->~T();
+        auto slot = reinterpret_cast<Slot *>(p);
+        slot->Next = m_free;
+        m_free = slot;
+        --m_live;
+    }
+
+    size_t Live() const
+    {
+        return m_live;
+    }
+
+    size_t Free() const
+    {
+        return Capacity() - m_live;
+    }
+
+    // all slots
+    size_t Capacity() const
+    {
+        return m_slabs.size() * m_slabSize;
+    }
+};
+
+} // namespace perilune
@@ -1,9 +1,15 @@
 #pragma once
 
 #include "common.h"
+#include "allocator.h"
+#include "gcbudget.h"
+#include "keytable.h"
 #include "applyer.h"
 #include "push.h"
 #include "get.h"
+#include "thunk.h"
+#include "field.h"
 #include "staticmethod.h"
 #include "indexdispatcher.h"
 #include "usertype.h"
+#include "typedarray.h"
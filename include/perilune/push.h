@@ -6,8 +6,15 @@ extern "C"
 }
 
 #include <stdint.h>
+#include <string.h>
+#include <array>
 #include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 #include <vector>
+#include "field.h"
 
 namespace perilune
 {
@@ -15,20 +22,16 @@ namespace perilune
 template <typename T>
 struct LuaPush
 {
-    template <typename... ARGS, std::size_t... IS>
-    static int _New(lua_State *L, std::tuple<ARGS...> args, std::index_sequence<IS...>)
+    // construct T in the userdata by the return value of f.
+    // a prvalue is constructed in place (guaranteed copy elision)
+    static const bool InPlace = true;
+
+    template <typename F>
+    static int Invoke(lua_State *L, const F &f)
     {
-        auto p = (T *)lua_newuserdata(L, sizeof(T));
-        // memset(p, 0, sizeof(T));
+        auto p = LuaNewUserData<T>(L);
         auto pushedType = LuaGetMetatable<T>(L);
-        if (pushedType)
-        {
-            // set metatable to type userdata
-            lua_setmetatable(L, -2);
-            new (p) T(std::get<IS>(args)...); // initialize. see Traits::Destruct
-            return 1;
-        }
-        else
+        if (!pushedType)
         {
             // no metatable
             lua_pop(L, 1);
@@ -38,59 +41,97 @@ struct LuaPush
             lua_error(L);
             return 1;
         }
+
+        new (p) T(f()); // initialize. see Traits::Destruct
+        // set metatable to type userdata after construction.
+        // no __gc for the userdata if the constructor throws
+        lua_setmetatable(L, -2);
+        StatsOnPush<T>(L, -1);
+        return 1;
     }
 
     template <typename... ARGS>
-    static int New(lua_State *L, std::tuple<ARGS...> args)
+    static int Emplace(lua_State *L, ARGS &&... args)
     {
-        return _New(L, args, std::index_sequence_for<ARGS...>());
+        return Invoke(L, [&args...]() { return T(std::forward<ARGS>(args)...); });
+    }
+
+    // getter, element... a scalars type is not one value
+    static void CheckNotScalars(lua_State *L)
+    {
+        if constexpr (IsScalarsCandidate<T>)
+        {
+            if (LuaScalars<T>::Is(L))
+            {
+                lua_pushfstring(L, "push scalars type [%s] as one value", typeid(T).name());
+                lua_error(L);
+            }
+        }
     }
 
     static int Push(lua_State *L, const T &value)
     {
-        auto p = (T *)lua_newuserdata(L, sizeof(T));
-        // memset(p, 0, sizeof(T));
-        auto pushedType = LuaGetMetatable<T>(L);
-        if (pushedType)
+        CheckNotScalars(L);
+        if constexpr (std::is_trivially_copyable<T>::value)
         {
-            // set metatable to type userdata
+            auto p = LuaNewUserData<T>(L);
+            if (!LuaGetMetatable<T>(L))
+            {
+                lua_pop(L, 1);
+                lua_pushfstring(L, "push unknown type [%s]", typeid(T).name());
+                lua_error(L);
+                return 1;
+            }
+            memcpy(p, &value, sizeof(T));
             lua_setmetatable(L, -2);
-            new (p) T; // initialize. see Traits::Destruct
-            *p = value;
+            StatsOnPush<T>(L, -1);
             return 1;
         }
         else
         {
-            // no metatable
-            lua_pop(L, 1);
-
-            // error
-            lua_pushfstring(L, "push unknown type [%s]", typeid(T).name());
-            lua_error(L);
-            return 1;
+            return Emplace(L, value);
         }
     }
+
+    static int Push(lua_State *L, T &&value)
+    {
+        CheckNotScalars(L);
+        return Emplace(L, std::move(value));
+    }
 };
 
 template <typename T>
 struct LuaPush<std::shared_ptr<T>>
 {
     using PT = std::shared_ptr<T>;
+
     static int Push(lua_State *L, const std::shared_ptr<T> &value)
+    {
+        return _Push(L, value);
+    }
+
+    // no reference count increment
+    static int Push(lua_State *L, std::shared_ptr<T> &&value)
+    {
+        return _Push(L, std::move(value));
+    }
+
+    template <typename V>
+    static int _Push(lua_State *L, V &&value)
     {
         if (!value)
         {
             return 0;
         }
 
-        auto p = (PT *)lua_newuserdata(L, sizeof(PT));
+        auto p = LuaNewUserData<PT>(L);
         auto pushedType = LuaGetMetatable<PT>(L);
         if (pushedType)
         {
+            new (p) PT(std::forward<V>(value)); // initialize. see Traits::Destruct
             // set metatable to type userdata
             lua_setmetatable(L, -2);
-            new (p) PT; // initialize. see Traits::Destruct
-            *p = value;
+            StatsOnPush<PT>(L, -1);
             return 1;
         }
         else
@@ -117,13 +158,14 @@ struct LuaPush<T *>
             return 0;
         }
 
-        auto p = (PT *)lua_newuserdata(L, sizeof(PT));
+        auto p = LuaNewUserData<PT>(L);
         auto pushedType = LuaGetMetatable<T *>(L);
         if (pushedType)
         {
             // set metatable to type userdata
             lua_setmetatable(L, -2);
             *p = value;
+            StatsOnPush<PT>(L, -1);
             return 1;
         }
         else
@@ -143,14 +185,15 @@ struct LuaPush<T &>
     using PT = T *;
     static int Push(lua_State *L, const T &value)
     {
-        auto p = (PT *)lua_newuserdata(L, sizeof(T));
-        memset(p, 0, sizeof(T));
+        // holds T* same as LuaPush<T*>
+        auto p = LuaNewUserData<PT>(L);
         auto pushedType = LuaGetMetatable<T *>(L);
         if (pushedType)
         {
             // set metatable to type userdata
             lua_setmetatable(L, -2);
             *p = &value;
+            StatsOnPush<PT>(L, -1);
             return 1;
         }
         else
@@ -240,52 +283,267 @@ struct LuaPush<std::string>
 {
     static int Push(lua_State *L, const std::string &s)
     {
-        lua_pushstring(L, s.c_str());
+        // keep embedded zeros
+        lua_pushlstring(L, s.data(), s.size());
         return 1;
     }
 };
 
-template <std::size_t N>
-struct LuaPush<std::array<float, N>>
+template <>
+struct LuaPush<std::string_view>
+{
+    static int Push(lua_State *L, std::string_view s)
+    {
+        lua_pushlstring(L, s.data(), s.size());
+        return 1;
+    }
+};
+
+template <>
+struct LuaPush<const char *>
+{
+    static int Push(lua_State *L, const char *s)
+    {
+        if (!s)
+        {
+            return 0;
+        }
+        lua_pushstring(L, s);
+        return 1;
+    }
+};
+
+// values pushed by LuaPushResult<T>. a nested tuple or pair is flattened
+template <typename T>
+struct LuaPushCount
+{
+    static const int Value = 1;
+};
+template <typename... ARGS>
+struct LuaPushCount<std::tuple<ARGS...>>
+{
+    static const int Value = (0 + ... + LuaPushCount<ARGS>::Value);
+};
+template <typename A, typename B>
+struct LuaPushCount<std::pair<A, B>>
+{
+    static const int Value = LuaPushCount<A>::Value + LuaPushCount<B>::Value;
+};
+
+// push exactly one value for a container element.
+// numbers are pushed directly
+template <typename T>
+void LuaPushElement(lua_State *L, const T &value)
+{
+    static_assert(LuaPushCount<T>::Value == 1, "an element is one value. not a tuple or pair");
+    if constexpr (std::is_same<T, bool>::value)
+    {
+        lua_pushboolean(L, value);
+    }
+    else if constexpr (std::is_integral<T>::value)
+    {
+        lua_pushinteger(L, static_cast<lua_Integer>(value));
+    }
+    else if constexpr (std::is_floating_point<T>::value)
+    {
+        lua_pushnumber(L, static_cast<lua_Number>(value));
+    }
+    else if (LuaPush<T>::Push(L, value) == 0)
+    {
+        lua_pushnil(L);
+    }
+}
+
+// table[1], table[2]... presized for the array part
+template <typename T>
+int LuaPushArray(lua_State *L, const T *values, size_t size)
+{
+    lua_createtable(L, static_cast<int>(size), 0);
+    for (size_t i = 0; i < size; ++i)
+    {
+        LuaPushElement(L, values[i]);
+        lua_rawseti(L, -2, static_cast<lua_Integer>(i + 1));
+    }
+    return 1;
+}
+
+template <typename T>
+struct LuaPush<std::vector<T>>
 {
-    static int Push(lua_State *L, const std::array<float, N> &a)
+    static int Push(lua_State *L, const std::vector<T> &list)
     {
-        lua_newtable(L);
-        for (int i = 0; i < N; ++i)
+        if constexpr (std::is_same<T, bool>::value)
         {
-            lua_pushinteger(L, i + 1);
-            lua_pushnumber(L, a[i]);
-            lua_settable(L, -3);
+            // std::vector<bool> has no data()
+            lua_createtable(L, static_cast<int>(list.size()), 0);
+            for (size_t i = 0; i < list.size(); ++i)
+            {
+                lua_pushboolean(L, list[i]);
+                lua_rawseti(L, -2, static_cast<lua_Integer>(i + 1));
+            }
+            return 1;
         }
+        else
+        {
+            return LuaPushArray(L, list.data(), list.size());
+        }
+    }
+};
+
+template <typename T, std::size_t N>
+struct LuaPush<std::array<T, N>>
+{
+    static int Push(lua_State *L, const std::array<T, N> &a)
+    {
+        return LuaPushArray(L, a.data(), N);
+    }
+};
+
+// push one element of multiple return values and return the pushed count
+template <typename T>
+int LuaPushResult(lua_State *L, const T &value)
+{
+    if constexpr (LuaPushCount<T>::Value == 1)
+    {
+        LuaPushElement(L, value);
         return 1;
     }
+    else
+    {
+        return LuaPush<T>::Push(L, value);
+    }
+}
+
+// multiple return values. no table
+template <typename... ARGS>
+struct LuaPush<std::tuple<ARGS...>>
+{
+    static const int Count = LuaPushCount<std::tuple<ARGS...>>::Value;
+
+    static int Push(lua_State *L, const std::tuple<ARGS...> &t)
+    {
+        if constexpr (Count > LUA_MINSTACK)
+        {
+            luaL_checkstack(L, Count, "too many results");
+        }
+        return _Push(L, t, std::index_sequence_for<ARGS...>());
+    }
+
+    template <std::size_t... IS>
+    static int _Push(lua_State *L, const std::tuple<ARGS...> &t, std::index_sequence<IS...>)
+    {
+        // left to right
+        int count = 0;
+        ((count += LuaPushResult(L, std::get<IS>(t))), ...);
+        return count;
+    }
+};
+
+template <typename A, typename B>
+struct LuaPush<std::pair<A, B>>
+{
+    static const int Count = LuaPushCount<std::pair<A, B>>::Value;
+
+    static int Push(lua_State *L, const std::pair<A, B> &p)
+    {
+        if constexpr (Count > LUA_MINSTACK)
+        {
+            luaL_checkstack(L, Count, "too many results");
+        }
+        auto count = LuaPushResult(L, p.first);
+        return count + LuaPushResult(L, p.second);
+    }
 };
 
 template <typename T>
 struct LuaIndexer
 {
+    static const bool IsContainer = false;
+
     static int Push(lua_State *L, T *t, lua_Integer luaIndex)
     {
         lua_pushfstring(L, "no integer index getter");
         lua_error(L);
         return 1;
     }
+
+    static void Set(lua_State *L, T *t, lua_Integer luaIndex, int valueIndex)
+    {
+        throw std::exception("no integer index setter");
+    }
 };
 
 template <typename T>
 struct LuaIndexer<std::vector<T>>
 {
+    static const bool IsContainer = true;
+
     static int Push(lua_State *L, std::vector<T> *t, lua_Integer luaIndex)
     {
-        auto index = luaIndex - 1;
-        if (index < 0)
-            return 0;
-        if (index >= (lua_Integer)t->size())
+        // 1 origin
+        auto index = static_cast<size_t>(luaIndex - 1);
+        if (index >= t->size())
             return 0;
 
-        auto value = (*t)[index];
-        return LuaPush<T>::Push(L, value);
+        // push from the element. no intermediate copy
+        return LuaPush<T>::Push(L, (*t)[index]);
+    }
+
+    static void Set(lua_State *L, std::vector<T> *t, lua_Integer luaIndex, int valueIndex)
+    {
+        auto index = static_cast<size_t>(luaIndex - 1);
+        if (index >= t->size())
+        {
+            throw std::exception("index out of range");
+        }
+        (*t)[index] = LuaGet<T>::Get(L, valueIndex);
     }
 };
 
+template <typename T, typename = void>
+struct IsPushInPlace : std::false_type
+{
+};
+
+template <typename T>
+struct IsPushInPlace<T, std::void_t<decltype(LuaPush<T>::InPlace)>> : std::true_type
+{
+};
+
+// push the return value of f() without a temporary copy.
+// SINGLE for a metamethod or getter. lua keeps only the first result
+template <typename R, bool SINGLE = false, typename F>
+int LuaPushInvoke(lua_State *L, const F &f)
+{
+    if constexpr (std::is_void<R>::value)
+    {
+        f();
+        return 0;
+    }
+    else if constexpr (IsPushInPlace<typename std::remove_cv<R>::type>::value)
+    {
+        using Type = typename std::remove_cv<R>::type;
+        if constexpr (IsScalarsCandidate<Type>)
+        {
+            // x, y, z. no userdata
+            if (LuaScalars<Type>::Is(L))
+            {
+                if constexpr (SINGLE)
+                {
+                    throw std::exception("scalars type returned as one value");
+                }
+                else
+                {
+                    return StructFields<Type>::Instance().PushScalars(L, f());
+                }
+            }
+        }
+        return LuaPush<Type>::Invoke(L, f);
+    }
+    else
+    {
+        return LuaPush<R>::Push(L, f());
+    }
+}
+
 } // namespace perilune
@@ -1,39 +1,66 @@
 #pragma once
 #include "common.h"
 #include "luafunc.h"
+#include "thunk.h"
+#include "keytable.h"
 
 namespace perilune
 {
 
 class StaticMethodMap
 {
-    std::unordered_map<std::string, LuaFunc> m_methodMap;
+    struct StaticValue
+    {
+        LuaFunc Body;
+        // compile time function. pushed without upvalue
+        lua_CFunction Thunk = nullptr;
+    };
+    KeyTable<StaticValue> m_methodMap;
 
 public:
     template <typename F, typename C, typename R, typename... ARGS>
     void StaticMethod(const char *name, const F &f, R (C::*m)(ARGS...) const)
     {
         auto lf = ToLuaFunc(name, f, m, std::index_sequence_for<ARGS...>());
-        m_methodMap.insert(std::make_pair(name, lf));
+        m_methodMap.Insert(name, StaticValue{lf});
     }
 
     void StaticMethod(const char *name, const LuaFunc lf)
     {
-        m_methodMap.insert(std::make_pair(name, lf));
+        m_methodMap.Insert(name, StaticValue{lf});
+    }
+
+    // pushed as light C function
+    void CFunction(const char *name, lua_CFunction thunk)
+    {
+        m_methodMap.Insert(name, StaticValue{nullptr, thunk});
+    }
+
+    // after registration
+    void Seal()
+    {
+        m_methodMap.Seal();
     }
 
     // stack#1: userdata
     // stack#2: key
     int Dispatch(lua_State *L)
     {
-        auto key = lua_tostring(L, 2);
+        size_t len;
+        auto key = lua_tolstring(L, 2, &len);
         if (key)
         {
-            auto found = m_methodMap.find(key);
-            if (found != m_methodMap.end())
+            auto found = m_methodMap.Find(key, len);
+            if (found)
             {
+                if (found->Thunk)
+                {
+                    lua_pushcfunction(L, found->Thunk);
+                    return 1;
+                }
+
                 // upvalue#1
-                lua_pushlightuserdata(L, &found->second);
+                lua_pushlightuserdata(L, &found->Body);
 
                 // return closure
                 lua_pushcclosure(L, &LuaFuncClosure, 1);
@@ -0,0 +1,172 @@
+#pragma once
+
+extern "C"
+{
+#include <lua.h>
+#include <lauxlib.h>
+}
+
+#include <stdint.h>
+#include <stdio.h>
+#include <algorithm>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+namespace perilune
+{
+
+#ifdef PERILUNE_STATS
+///
+/// live instance and byte counters for each userdata holder type (T, T *, std::shared_ptr<T>).
+/// compiled in by PERILUNE_STATS. the hooks are empty without it.
+/// the counters are shared by all lua_State and are not thread safe.
+///
+struct UserTypeStats
+{
+    // typeid(T).name()
+    const char *Name = nullptr;
+    // userdata created
+    uint64_t Created = 0;
+    // not collected
+    uint64_t Live = 0;
+    // lua_rawlen of the live userdata
+    uint64_t Bytes = 0;
+    uint64_t PeakLive = 0;
+    uint64_t PeakBytes = 0;
+};
+
+class StatsRegistry
+{
+    std::vector<const UserTypeStats *> m_types;
+
+public:
+    static StatsRegistry &Instance()
+    {
+        static StatsRegistry s_instance;
+        return s_instance;
+    }
+
+    void Add(const UserTypeStats *stats)
+    {
+        m_types.push_back(stats);
+    }
+
+    // sorted by Bytes
+    std::vector<UserTypeStats> Snapshot() const
+    {
+        std::vector<UserTypeStats> list;
+        list.reserve(m_types.size());
+        for (auto stats : m_types)
+        {
+            list.push_back(*stats);
+        }
+        std::stable_sort(list.begin(), list.end(), [](const UserTypeStats &l, const UserTypeStats &r) {
+            return l.Bytes > r.Bytes;
+        });
+        return list;
+    }
+};
+
+template <typename U>
+UserTypeStats &TypeStats()
+{
+    static UserTypeStats *s_stats = []() {
+        auto stats = new UserTypeStats;
+        stats->Name = typeid(U).name();
+        StatsRegistry::Instance().Add(stats);
+        return stats;
+    }();
+    return *s_stats;
+}
+
+// top types by bytes. a line per type
+inline std::string HeapReport(size_t top = 10)
+{
+    std::string report;
+    char line[512];
+    for (auto &stats : StatsRegistry::Instance().Snapshot())
+    {
+        if (top-- == 0)
+        {
+            break;
+        }
+        snprintf(line, sizeof(line), "%-40s live %8llu bytes %10llu (peak %llu / %llu)\n",
+                 stats.Name,
+                 (unsigned long long)stats.Live, (unsigned long long)stats.Bytes,
+                 (unsigned long long)stats.PeakLive, (unsigned long long)stats.PeakBytes);
+        report += line;
+    }
+    return report;
+}
+
+// perilune.stats([n]). array of the top n types by bytes
+inline int LuaStats(lua_State *L)
+{
+    auto list = StatsRegistry::Instance().Snapshot();
+    auto n = static_cast<size_t>(luaL_optinteger(L, 1, static_cast<lua_Integer>(list.size())));
+    n = std::min(n, list.size());
+    lua_createtable(L, static_cast<int>(n), 0);
+    for (size_t i = 0; i < n; ++i)
+    {
+        auto &stats = list[i];
+        lua_createtable(L, 0, 6);
+        lua_pushstring(L, stats.Name);
+        lua_setfield(L, -2, "name");
+        lua_pushinteger(L, static_cast<lua_Integer>(stats.Created));
+        lua_setfield(L, -2, "created");
+        lua_pushinteger(L, static_cast<lua_Integer>(stats.Live));
+        lua_setfield(L, -2, "live");
+        lua_pushinteger(L, static_cast<lua_Integer>(stats.Bytes));
+        lua_setfield(L, -2, "bytes");
+        lua_pushinteger(L, static_cast<lua_Integer>(stats.PeakLive));
+        lua_setfield(L, -2, "peak_live");
+        lua_pushinteger(L, static_cast<lua_Integer>(stats.PeakBytes));
+        lua_setfield(L, -2, "peak_bytes");
+        lua_rawseti(L, -2, static_cast<lua_Integer>(i + 1));
+    }
+    return 1;
+}
+
+// global perilune.stats
+inline void LuaOpenStats(lua_State *L)
+{
+    if (lua_getglobal(L, "perilune") != LUA_TTABLE)
+    {
+        lua_pop(L, 1);
+        lua_newtable(L);
+        lua_pushvalue(L, -1);
+        lua_setglobal(L, "perilune");
+    }
+    lua_pushcfunction(L, &LuaStats);
+    lua_setfield(L, -2, "stats");
+    lua_pop(L, 1);
+}
+#endif
+
+// userdata of U at index got the metatable
+template <typename U>
+inline void StatsOnPush(lua_State *L, int index)
+{
+#ifdef PERILUNE_STATS
+    auto &stats = TypeStats<U>();
+    ++stats.Created;
+    ++stats.Live;
+    stats.Bytes += lua_rawlen(L, index);
+    stats.PeakLive = std::max(stats.PeakLive, stats.Live);
+    stats.PeakBytes = std::max(stats.PeakBytes, stats.Bytes);
+#endif
+}
+
+// __gc of the userdata of U at index
+template <typename U>
+inline void StatsOnGc(lua_State *L, int index)
+{
+#ifdef PERILUNE_STATS
+    auto &stats = TypeStats<U>();
+    --stats.Live;
+    stats.Bytes -= lua_rawlen(L, index);
+#endif
+}
+
+} // namespace perilune
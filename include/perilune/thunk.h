@@ -0,0 +1,128 @@
+#pragma once
+#include "common.h"
+#include "applyer.h"
+
+namespace perilune
+{
+
+// raise C++ exception as lua error
+template <typename F>
+int LuaTryCall(lua_State *L, const F &f)
+{
+    try
+    {
+        return f();
+    }
+    catch (const std::exception &ex)
+    {
+        lua_pushstring(L, ex.what());
+        lua_error(L);
+        return 1;
+    }
+    catch (...)
+    {
+        lua_pushstring(L, "error in thunk");
+        lua_error(L);
+        return 1;
+    }
+}
+
+///
+/// dedicated lua_CFunction for a function known at compile time.
+/// no upvalue for the body and no std::function.
+///
+/// lua_pushcfunction(L, &StaticThunk<&fn>::Call);
+///
+template <auto F, typename S = decltype(F)>
+struct StaticThunk;
+
+template <auto F, typename R, typename... ARGS>
+struct StaticThunk<F, R (*)(ARGS...)>
+{
+    template <std::size_t... IS>
+    static int Invoke(lua_State *L, std::index_sequence<IS...>)
+    {
+        auto args = LuaArgs<ARGS...>(L, 1);
+        return LuaPushInvoke<R>(L, [&]() -> R { return LuaApply(F, args); });
+    }
+
+    static int Call(lua_State *L)
+    {
+        return LuaTryCall(L, [L]() {
+            return Invoke(L, std::index_sequence_for<ARGS...>());
+        });
+    }
+};
+
+///
+/// dedicated lua_CFunction for a member function known at compile time.
+///
+/// [obj.method(...)]
+/// lua_pushvalue(L, 1); // upvalue #1: userdata
+/// lua_pushcclosure(L, &MethodThunk<T, &C::method>::SelfFromUpvalue1, 1);
+///
+/// [obj:method(...)]
+/// lua_pushcfunction(L, &MethodThunk<T, &C::method>::SelfFromStack1);
+///
+template <typename T, auto M, typename S = decltype(M)>
+struct MethodThunk;
+
+template <typename T, auto M, typename R, typename C, typename... ARGS>
+struct MethodThunk<T, M, R (C::*)(ARGS...)>
+{
+    using RawType = typename Traits<T>::RawType;
+
+    template <std::size_t... IS>
+    static int Invoke(lua_State *L, RawType *self, int index, std::index_sequence<IS...>)
+    {
+        auto args = LuaArgs<ARGS...>(L, index);
+        return Applyer<R, RawType, ARGS...>::Apply(L, self, M, LuaArgAt<IS>(args).Get()...);
+    }
+
+    static int SelfFromUpvalue1(lua_State *L)
+    {
+        return LuaTryCall(L, [L]() {
+            auto self = Traits<T>::GetSelf(L, lua_upvalueindex(1));
+            return Invoke(L, self, 1, std::index_sequence_for<ARGS...>());
+        });
+    }
+
+    static int SelfFromStack1(lua_State *L)
+    {
+        return LuaTryCall(L, [L]() {
+            auto self = Traits<T>::GetSelf(L, 1);
+            return Invoke(L, self, 2, std::index_sequence_for<ARGS...>());
+        });
+    }
+};
+
+template <typename T, auto M, typename R, typename C, typename... ARGS>
+struct MethodThunk<T, M, R (C::*)(ARGS...) const>
+{
+    using RawType = typename Traits<T>::RawType;
+
+    template <std::size_t... IS>
+    static int Invoke(lua_State *L, RawType *self, int index, std::index_sequence<IS...>)
+    {
+        auto args = LuaArgs<ARGS...>(L, index);
+        return ConstApplyer<R, RawType, ARGS...>::Apply(L, self, M, LuaArgAt<IS>(args).Get()...);
+    }
+
+    static int SelfFromUpvalue1(lua_State *L)
+    {
+        return LuaTryCall(L, [L]() {
+            auto self = Traits<T>::GetSelf(L, lua_upvalueindex(1));
+            return Invoke(L, self, 1, std::index_sequence_for<ARGS...>());
+        });
+    }
+
+    static int SelfFromStack1(lua_State *L)
+    {
+        return LuaTryCall(L, [L]() {
+            auto self = Traits<T>::GetSelf(L, 1);
+            return Invoke(L, self, 2, std::index_sequence_for<ARGS...>());
+        });
+    }
+};
+
+} // namespace perilune
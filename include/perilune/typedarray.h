@@ -0,0 +1,197 @@
+#pragma once
+#include <string.h>
+#include <algorithm>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <vector>
+#include "common.h"
+#include "usertype.h"
+
+namespace perilune
+{
+
+///
+/// contiguous array of arithmetic or POD elements.
+/// a slice is a view that shares the storage.
+/// a view is clamped to the storage, so a shrinking Resize cuts other views short
+///
+template <typename T>
+class TypedArray
+{
+    static_assert(std::is_trivially_copyable<T>::value, "TypedArray<T> requires trivially copyable T");
+
+    std::shared_ptr<std::vector<T>> m_storage;
+    size_t m_offset = 0;
+    size_t m_count = 0;
+
+public:
+    TypedArray()
+        : m_storage(std::make_shared<std::vector<T>>())
+    {
+    }
+
+    explicit TypedArray(size_t count)
+        : m_storage(std::make_shared<std::vector<T>>(count)), m_count(count)
+    {
+    }
+
+    // elements of the view that are in the storage
+    size_t size() const
+    {
+        auto storage = m_storage->size();
+        if (m_offset >= storage)
+        {
+            return 0;
+        }
+        return std::min(m_count, storage - m_offset);
+    }
+
+    T *data()
+    {
+        return m_storage->data() + m_offset;
+    }
+
+    const T *data() const
+    {
+        return m_storage->data() + m_offset;
+    }
+
+    std::span<T> Span()
+    {
+        return std::span<T>(data(), size());
+    }
+
+    std::span<const T> Span() const
+    {
+        return std::span<const T>(data(), size());
+    }
+
+    // view of [offset, offset + count)
+    TypedArray Slice(size_t offset, size_t count) const
+    {
+        auto size = this->size();
+        if (offset > size || count > size - offset)
+        {
+            throw std::exception("slice out of range");
+        }
+        TypedArray slice(*this);
+        slice.m_offset = m_offset + offset;
+        slice.m_count = count;
+        return slice;
+    }
+
+    // memmove. slices of the same storage may overlap
+    // both clamped to the storage
+    size_t CopyFrom(const TypedArray &src)
+    {
+        auto count = std::min(size(), src.size());
+        memmove(data(), src.data(), count * sizeof(T));
+        return count;
+    }
+
+    bool IsSlice() const
+    {
+        return m_offset != 0 || m_count != m_storage->size();
+    }
+
+    // slices keep their offset and count into the storage
+    void Resize(size_t count)
+    {
+        if (IsSlice())
+        {
+            throw std::exception("resize a slice");
+        }
+        m_storage->resize(count);
+        m_count = count;
+    }
+};
+
+template <typename T>
+struct LuaIndexer<TypedArray<T>>
+{
+    static const bool IsContainer = true;
+
+    static int Push(lua_State *L, TypedArray<T> *t, lua_Integer luaIndex)
+    {
+        // 1 origin
+        auto index = static_cast<size_t>(luaIndex - 1);
+        if (index >= t->size())
+            return 0;
+
+        LuaPushElement(L, t->data()[index]);
+        return 1;
+    }
+
+    static void Set(lua_State *L, TypedArray<T> *t, lua_Integer luaIndex, int valueIndex)
+    {
+        auto index = static_cast<size_t>(luaIndex - 1);
+        if (index >= t->size())
+        {
+            throw std::exception("index out of range");
+        }
+        t->data()[index] = LuaGetElement<T>(L, valueIndex);
+    }
+};
+
+// the storage of TypedArray<T> userdata
+template <typename T>
+struct LuaGet<std::span<T>>
+{
+    static std::span<T> Get(lua_State *L, int index)
+    {
+        auto p = LuaToRaw<TypedArray<typename std::remove_const<T>::type>>(L, index);
+        if (!p)
+        {
+            throw std::exception("not TypedArray");
+        }
+        return p->Span();
+    }
+};
+
+// for TypedArray<T>
+//
+// local a = FloatArray.new(4)
+// a[1] = 1.5
+// local s = a.slice(2, 2) -- a[2], a[3]
+// a.resize(8)
+// a.copy(b) -- memmove min(#a, #b) elements
+template <typename T>
+void AddTypedArrayMethods(UserType<TypedArray<T>> &userType)
+{
+    using RawType = TypedArray<T>;
+
+    userType
+        .StaticMethod("new", [](int count) {
+            if (count < 0)
+            {
+                throw std::exception("negative size");
+            }
+            return RawType(count);
+        })
+        .MetaMethod(perilune::MetaKey::__len, [](RawType *p) {
+            return p->size();
+        })
+        .MetaIndexDispatcher([](perilune::IndexDispatcher<RawType> *d) {
+            // 1 origin
+            d->Method("slice", [](RawType *p, int offset, int count) {
+                if (offset < 1 || count < 0)
+                {
+                    throw std::exception("slice out of range");
+                }
+                return p->Slice(offset - 1, count);
+            });
+            d->Method("copy", [](RawType *p, const RawType &src) {
+                return static_cast<int>(p->CopyFrom(src));
+            });
+            d->Method("resize", [](RawType *p, int count) {
+                if (count < 0)
+                {
+                    throw std::exception("negative size");
+                }
+                p->Resize(count);
+            });
+        });
+}
+
+} // namespace perilune
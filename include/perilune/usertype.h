@@ -2,10 +2,21 @@
 
 #include "common.h"
 #include "luafunc.h"
+#include "objectpool.h"
 
 namespace perilune
 {
 
+#ifdef PERILUNE_STATS
+// __gc registered by MetaMethod replaces Traits<T>::Destruct. count before it
+template <typename T>
+int LuaStatsGcClosure(lua_State *L)
+{
+    StatsOnGc<T>(L, 1);
+    return LuaFuncClosure(L);
+}
+#endif
+
 template <typename T>
 class UserType
 {
@@ -23,13 +34,20 @@ class UserType
     // instance method dispatcher(object methods bind this pointer)
     std::unordered_map<MetaKey, LuaFunc> m_metamethodMap;
     IndexDispatcher<T> m_indexDispatcher;
-    LuaFunc m_instanceIndexClosure;
+
+    // obj:method(...)
+    bool m_colonCall = false;
+
+    // return T as numbers
+    bool m_returnAsScalars = false;
+
+    // new and __gc by Pooled
+    std::unique_ptr<ObjectPool<typename Traits<T>::RawType>> m_pool;
 
 public:
     UserType()
     {
         m_typeIndexClosure = std::bind(&StaticMethodMap::Dispatch, &m_staticMethods, std::placeholders::_1);
-        m_instanceIndexClosure = std::bind(&IndexDispatcher<T>::Dispatch, &m_indexDispatcher, std::placeholders::_1);
     }
 
     ~UserType()
@@ -41,10 +59,13 @@ public:
     UserType &PlacementNew(const char *name)
     {
         m_staticMethods.StaticMethod(name, [](lua_State *L) {
-            auto args = LuaArgsToTuple<ARGS...>(L, 1);
-            return LuaPush<T>::New(L, args);
+            auto args = LuaArgs<ARGS...>(L, 1);
+            return LuaApply([L](auto &&... a) {
+                return LuaPush<T>::Emplace(L, std::forward<decltype(a)>(a)...);
+            },
+                            args);
         });
-        MetaMethod(perilune::MetaKey::__gc, [](T *p) { p->~T(); });
+        // __gc is set by Traits<T>::SetPlacementDelete. none for trivially destructible T
         return *this;
     }
 
@@ -56,6 +77,35 @@ public:
         return *this;
     }
 
+    // new and __gc from a slab pool of capacity objects. grows by capacity.
+    // once. the registered new and __gc hold the pool
+    UserType &Pooled(size_t capacity)
+    {
+        static_assert(std::is_pointer<T>::value, "UserType<T *>");
+        assert(!m_pool);
+        using RawType = typename Traits<T>::RawType;
+        m_pool.reset(new ObjectPool<RawType>(capacity));
+        auto pool = m_pool.get();
+        StaticMethod("new", [pool]() { return pool->New(); });
+        MetaMethod(perilune::MetaKey::__gc, [pool](T p) { pool->Delete(p); });
+        return *this;
+    }
+
+    // nullptr if not Pooled
+    const ObjectPool<typename Traits<T>::RawType> *Pool() const
+    {
+        return m_pool.get();
+    }
+
+#ifdef PERILUNE_STATS
+    // counters of the userdata that holds T.
+    // process-global: summed over every lua_State and every UserType<T>, not this instance
+    const UserTypeStats &Stats() const
+    {
+        return TypeStats<T>();
+    }
+#endif
+
     // for lambda
     template <typename F>
     UserType &StaticMethod(const char *name, F f)
@@ -64,6 +114,15 @@ public:
         return *this;
     }
 
+    // for function pointer known at compile time
+    // StaticMethod<&fn>("name")
+    template <auto F>
+    UserType &StaticMethod(const char *name)
+    {
+        m_staticMethods.CFunction(name, &StaticThunk<F>::Call);
+        return *this;
+    }
+
     UserType &LuaMetaMethod(MetaKey key, const LuaFunc &lf)
     {
         m_metamethodMap.insert(std::make_pair(key, lf));
@@ -78,6 +137,32 @@ public:
         return *this;
     }
 
+    // reuse bound method closures. obj.method is cached in the user value of obj
+    UserType &CacheBoundMethods()
+    {
+        m_indexDispatcher.CacheBoundMethods();
+        return *this;
+    }
+
+    // methods take self from argument#1. obj:method(...)
+    // __index is a prebuilt method table if there is no getter
+    UserType &ColonCall()
+    {
+        m_colonCall = true;
+        return *this;
+    }
+
+    // functions returning T push the registered fields as numbers, x, y, z.
+    // parameters of T accept the userdata or the same count of numbers.
+    // only in the lua_State of LuaNewType. a metamethod, getter or element
+    // of T raises an error, lua keeps one value of them
+    UserType &ReturnAsScalars()
+    {
+        static_assert(IsScalarsCandidate<typename Traits<T>::RawType>, "small trivially copyable struct");
+        m_returnAsScalars = true;
+        return *this;
+    }
+
     UserType &MetaIndexDispatcher(const std::function<void(IndexDispatcher<T> *)> &f)
     {
         f(&m_indexDispatcher);
@@ -86,6 +171,17 @@ public:
 
     void LuaNewType(lua_State *L)
     {
+        // no more registration
+        m_staticMethods.Seal();
+        m_indexDispatcher.Seal();
+        if (m_returnAsScalars)
+        {
+            // fields are registered by MetaIndexDispatcher
+            using RawType = typename Traits<T>::RawType;
+            StructFields<RawType>::Instance().CheckScalars();
+            LuaScalars<RawType>::Set(L);
+        }
+
         // store this to registory
         lua_pushlightuserdata(L, (void *)typeid(UserType).hash_code()); // key
         lua_pushlightuserdata(L, this);                                 // value
@@ -94,7 +190,8 @@ public:
         // create metatable for type userdata
         // LuaNewTypeMetaTable(L);
         {
-            assert(luaL_newmetatable(L, typeid(T).name()) == 1);
+            auto created = luaL_newmetatable(L, typeid(T).name());
+            assert(created == 1);
             int metatable = lua_gettop(L);
 
             {
@@ -115,18 +212,39 @@ public:
             // first time
             int metatable = lua_gettop(L);
 
+            if (m_colonCall)
             {
-                lua_pushlightuserdata(L, &m_instanceIndexClosure);
-                lua_pushcclosure(L, &LuaFuncClosure, 1);
+                m_indexDispatcher.PushMethodTable(L);
+                if (!m_indexDispatcher.IsMethodOnly())
+                {
+                    int methodTable = lua_gettop(L);
+                    m_indexDispatcher.PushLuaIndex(L, methodTable);
+                    lua_remove(L, methodTable);
+                }
                 lua_setfield(L, metatable, "__index");
             }
+            else
+            {
+                m_indexDispatcher.PushLuaIndex(L, 0);
+                lua_setfield(L, metatable, "__index");
+            }
+
+            if (m_indexDispatcher.HasSetter())
+            {
+                m_indexDispatcher.PushLuaNewIndex(L);
+                lua_setfield(L, metatable, "__newindex");
+            }
 
             Traits<T>::SetPlacementDelete(L, metatable);
 
             for (auto &kv : m_metamethodMap)
             {
                 lua_pushlightuserdata(L, &kv.second);
+#ifdef PERILUNE_STATS
+                lua_pushcclosure(L, kv.first == MetaKey::__gc ? &LuaStatsGcClosure<T> : &LuaFuncClosure, 1);
+#else
                 lua_pushcclosure(L, &LuaFuncClosure, 1);
+#endif
                 lua_setfield(L, metatable, ToString(kv.first));
             }
 
@@ -135,7 +253,7 @@ public:
 
         {
             // push userdata for Type
-            auto p = (UserTypeDummy *)lua_newuserdata(L, sizeof(UserTypeDummy));
+            auto p = LuaNewUserData<UserTypeDummy>(L);
             // set metatable to type userdata
             auto pushedType = luaL_getmetatable(L, typeid(T).name());
             lua_setmetatable(L, -2);
@@ -154,14 +272,10 @@ void AddDefaultMethods(UserType<T> &userType)
             return p->size();
         })
         .MetaIndexDispatcher([](perilune::IndexDispatcher<T> *d) {
-            // upvalue#2: userdata
-            d->LuaMethod("push_back", [](lua_State *L) {
-                auto value = perilune::Traits<T>::GetSelf(L, lua_upvalueindex(2));
-                auto v = perilune::LuaGet<RawType::value_type>::Get(L, 1);
+            d->Method("push_back", [](RawType *value, const typename RawType::value_type &v) {
                 value->push_back(v);
-                return 0;
             });
         });
 }
 
-} // namespace perilune
\ No newline at end of file
+} // namespace perilune
\ No newline at end of file
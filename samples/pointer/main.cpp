@@ -9,15 +9,21 @@ struct Lua
     lua_State *L;
 
     Lua()
-        : L(luaL_newstate())
+        : L(perilune::NewState(Options()))
     {
-        luaL_requiref(L, "_G", luaopen_base, 1);
-        lua_pop(L, 1);
     }
 
     ~Lua()
     {
-        lua_close(L);
+        perilune::CloseState(L);
+    }
+
+    // pooled allocator and the base library
+    static perilune::StateOptions Options()
+    {
+        perilune::StateOptions options;
+        options.OpenLibs = false;
+        return options;
     }
 
     void PrintLuaError()
@@ -55,6 +61,7 @@ int main(int argc, char **argv)
             std::cerr << "destruct: " << p << std::endl;
             delete p;
         })
+        .CacheBoundMethods()
         .MetaIndexDispatcher([](auto d) {
             d->Method("create", &Win32Window::Create);
             d->Method("is_running", &Win32Window::IsRunning);
@@ -67,6 +74,7 @@ int main(int argc, char **argv)
     dx11
         .StaticMethod("new", []() { return new DX11Context; })
         .MetaMethod(perilune::MetaKey::__gc, [](DX11Context *p) { delete p; })
+        .CacheBoundMethods()
         .MetaIndexDispatcher([](auto d) {
             d->Method("create", &DX11Context::Create);
             d->Method("new_frame", &DX11Context::NewFrame);
@@ -76,6 +84,15 @@ int main(int argc, char **argv)
         .LuaNewType(lua.L);
     lua_setglobal(lua.L, "Dx11");
 
+    // gc runs in gc_step at the end of each frame. destroyed before lua
+    perilune::GcBudgetOptions gcOptions;
+    gcOptions.Mode = perilune::GcMode::Generational;
+    gcOptions.BudgetMicroseconds = 1000;
+    perilune::GcBudget gc(lua.L, gcOptions);
+    lua_pushlightuserdata(lua.L, &gc);
+    lua_pushcclosure(lua.L, &perilune::GcBudget::LuaStep, 1);
+    lua_setglobal(lua.L, "gc_step");
+
     if (!lua.DoFile(argv[1]))
     {
         return 2;
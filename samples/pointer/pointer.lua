@@ -27,4 +27,5 @@ while window.is_running() do
     -- do something
 
     dx11.present()
+    gc_step()
 end
@@ -6,15 +6,21 @@ struct Lua
     lua_State *L;
 
     Lua()
-        : L(luaL_newstate())
+        : L(perilune::NewState(Options()))
     {
-        luaL_requiref(L, "_G", luaopen_base, 1);
-        lua_pop(L, 1);
     }
 
     ~Lua()
     {
-        lua_close(L);
+        perilune::CloseState(L);
+    }
+
+    // pooled allocator and the base library
+    static perilune::StateOptions Options()
+    {
+        perilune::StateOptions options;
+        options.OpenLibs = false;
+        return options;
     }
 
     void PrintLuaError()
@@ -54,43 +60,28 @@ struct Vector3
         return Vector3(x + v.x, y + v.y, z + v.z);
     }
 
-    float SqNorm() const
+    Vector3 &operator+=(const Vector3 &v)
     {
-        return x * x + y * y + z * z;
+        x += v.x;
+        y += v.y;
+        z += v.z;
+        return *this;
     }
-};
-
-namespace perilune
-{
 
-template <>
-struct LuaTable<Vector3>
-{
-    static Vector3 Get(lua_State *L, int index)
+    Vector3 &operator*=(float s)
     {
-        Vector3 v;
-
-        lua_pushinteger(L, 1);
-        lua_gettable(L, -2);
-        v.x = (float)lua_tonumber(L, -1);
-        lua_pop(L, 1);
-
-        lua_pushinteger(L, 2);
-        lua_gettable(L, -2);
-        v.y = (float)lua_tonumber(L, -1);
-        lua_pop(L, 1);
-
-        lua_pushinteger(L, 3);
-        lua_gettable(L, -2);
-        v.z = (float)lua_tonumber(L, -1);
-        lua_pop(L, 1);
+        x *= s;
+        y *= s;
+        z *= s;
+        return *this;
+    }
 
-        return v;
+    float SqNorm() const
+    {
+        return x * x + y * y + z * z;
     }
 };
 
-} // namespace perilune
-
 int main(int argc, char **argv)
 {
     if (argc == 1)
@@ -124,7 +115,15 @@ int main(int argc, char **argv)
             d->Getter("y", &Vector3::y);
             d->Getter("z", &Vector3::z);
             d->Method("sqnorm", &Vector3::SqNorm);
+            d->Setter("x", &Vector3::x);
+            d->Setter("y", &Vector3::y);
+            d->Setter("z", &Vector3::z);
+            // acc.add_(v) and acc.scale_(s) update acc. no new userdata
+            d->InPlaceAdd();
+            d->template InPlaceMul<float>("scale_");
         })
+        // reuse acc.add_ closure
+        .CacheBoundMethods()
         // create and push lua stack
         .LuaNewType(lua.L);
     lua_setglobal(lua.L, "Vector3");
@@ -13,6 +13,8 @@ print(v.y)
 print(v.z)
 local n = v.sqnorm()
 print(n)
+v.x = 10
+print(v)
 
 local list = Vector3List.New()
 print(list, #list)
@@ -27,3 +29,9 @@ local y = v + Vector3.New(1, 2, 3)
 print(y)
 local z = y + {1, 2, 3}
 print(z)
+local w = y + {x = 1, y = 2, z = 3}
+print(w)
+
+local acc = Vector3.Zero()
+for i = 1, 3 do acc.add_(v) end
+print(acc.scale_(0.5))
@@ -0,0 +1,83 @@
+#include <catch.hpp>
+#include <perilune/perilune.h>
+
+TEST_CASE("pooled state", "[allocator]")
+{
+    struct Vector3
+    {
+        float x = 0;
+        float y = 0;
+        float z = 0;
+    };
+
+    auto L = perilune::NewState();
+    auto allocator = perilune::GetPoolAllocator(L);
+    REQUIRE(allocator);
+
+    {
+        static perilune::UserType<Vector3> vector3Type;
+        vector3Type
+            .StaticMethod("new", []() { return Vector3{}; })
+            .LuaNewType(L);
+        lua_setglobal(L, "Vector3");
+    }
+
+    auto live = [allocator]() {
+        uint64_t live = 0;
+        for (auto &c : allocator->Stats())
+        {
+            live += c.Live;
+        }
+        return live;
+    };
+
+    lua_gc(L, LUA_GCCOLLECT, 0);
+    auto before = live();
+
+    auto result = luaL_dostring(L, R""(
+local list = {}
+for i = 1, 1000 do list[i] = Vector3.new() end
+list = nil
+collectgarbage()
+collectgarbage()
+local s = {}
+for i = 1, 100 do s[i] = string.rep('x', i * 10) end
+return #s
+)"");
+    REQUIRE(LUA_OK == result);
+    lua_pop(L, 1);
+    lua_gc(L, LUA_GCCOLLECT, 0);
+
+    // freed blocks are back
+    REQUIRE(live() == before);
+
+    uint64_t pooled = 0;
+    auto &stats = allocator->Stats();
+    for (size_t i = 0; i < perilune::PoolAllocator::ClassCount; ++i)
+    {
+        REQUIRE(stats[i].Size == (i + 1) * perilune::PoolAllocator::Alignment);
+        pooled += stats[i].Blocks;
+    }
+    REQUIRE(pooled >= 1000);
+    // string.rep
+    REQUIRE(stats[perilune::PoolAllocator::ClassCount].Blocks > 0);
+
+    perilune::CloseState(L);
+}
+
+TEST_CASE("libc state", "[allocator]")
+{
+    perilune::StateOptions options;
+    options.PooledAllocator = false;
+    options.OpenLibs = false;
+    auto L = perilune::NewState(options);
+    REQUIRE(!perilune::GetPoolAllocator(L));
+
+    // base library only
+    lua_getglobal(L, "print");
+    REQUIRE(lua_isfunction(L, -1));
+    lua_getglobal(L, "string");
+    REQUIRE(lua_isnil(L, -1));
+
+    perilune::CloseState(L);
+}
@@ -0,0 +1,97 @@
+#include <catch.hpp>
+#include <perilune/perilune.h>
+
+TEST_CASE("gc budget", "[gc]")
+{
+    struct Vector3
+    {
+        float x = 0;
+        float y = 0;
+        float z = 0;
+    };
+
+    auto L = luaL_newstate();
+    luaL_openlibs(L);
+
+    static perilune::UserType<Vector3> vector3Type;
+    vector3Type
+        .StaticMethod("new", []() { return Vector3{}; })
+        .LuaNewType(L);
+    lua_setglobal(L, "Vector3");
+
+    // garbage of a frame
+    luaL_dostring(L, R""(
+return function()
+    local list = {}
+    for i = 1, 2000 do list[i] = Vector3.new() end
+end
+)"");
+    int frame = lua_gettop(L);
+
+    auto run = [L, frame](perilune::GcBudget &gc) {
+        int maxHeapKB = 0;
+        for (int i = 0; i < 200; ++i)
+        {
+            lua_pushvalue(L, frame);
+            lua_call(L, 0, 0);
+            auto &stats = gc.Step();
+            REQUIRE(stats.Steps > 0);
+            if (i >= 100)
+            {
+                maxHeapKB = std::max(maxHeapKB, stats.HeapKB);
+            }
+        }
+        return maxHeapKB;
+    };
+
+    SECTION("incremental")
+    {
+        perilune::GcBudgetOptions options;
+        options.BudgetMicroseconds = 100000;
+        perilune::GcBudget gc(L, options);
+        // only Step collects
+        REQUIRE(0 == lua_gc(L, LUA_GCISRUNNING, 0));
+
+        auto maxHeapKB = run(gc);
+        REQUIRE(200 == gc.Frames());
+        REQUIRE(gc.Frame().StepKB > options.MinStepKB);
+        // the collector keeps up. 200 frames of garbage is 200 * 2000 userdata
+        REQUIRE(maxHeapKB < 4 * 1024);
+        REQUIRE(gc.MaxMicroseconds() > 0);
+    }
+
+    SECTION("generational")
+    {
+        perilune::GcBudgetOptions options;
+        options.Mode = perilune::GcMode::Generational;
+        options.BudgetMicroseconds = 100000;
+        {
+            perilune::GcBudget gc(L, options);
+
+            auto maxHeapKB = run(gc);
+            REQUIRE(1 == gc.Frame().Steps);
+            REQUIRE(maxHeapKB < 4 * 1024);
+        }
+
+        // back to the incremental mode of the new state. LUA_GCINC returns the previous mode
+        REQUIRE(1 == lua_gc(L, LUA_GCISRUNNING, 0));
+        REQUIRE(LUA_GCINC == lua_gc(L, LUA_GCINC, 0, 0, 0));
+    }
+
+    SECTION("budget")
+    {
+        perilune::GcBudgetOptions options;
+        options.BudgetMicroseconds = 0;
+        perilune::GcBudget gc(L, options);
+
+        // the first slice is always run
+        lua_pushvalue(L, frame);
+        lua_call(L, 0, 0);
+        auto &stats = gc.Step();
+        REQUIRE(1 == stats.Steps);
+    }
+
+    // restarted
+    REQUIRE(1 == lua_gc(L, LUA_GCISRUNNING, 0));
+    lua_close(L);
+}
@@ -0,0 +1,245 @@
+#include <catch.hpp>
+#include <perilune/perilune.h>
+
+TEST_CASE("setter", "[index]")
+{
+    struct Vec2
+    {
+        float X = 0;
+        float Y = 0;
+        int Writes = 0;
+    };
+
+    auto L = luaL_newstate();
+    luaL_openlibs(L);
+
+    {
+        static perilune::UserType<Vec2 *> vec2Type;
+        vec2Type
+            .DefaultConstructorAndDestructor()
+            .MetaIndexDispatcher([](auto d) {
+                d->Getter("x", &Vec2::X);
+                d->Setter("x", &Vec2::X);
+                d->Getter("y", &Vec2::Y);
+                d->Setter("y", [](Vec2 *self, float y) {
+                    self->Y = y;
+                    ++self->Writes;
+                });
+                // write only
+                d->Setter("writes", &Vec2::Writes);
+            })
+            .LuaNewType(L);
+        lua_setglobal(L, "Vec2");
+    }
+
+    SECTION("field and lambda")
+    {
+        luaL_dostring(L, R""(
+local v = Vec2.new()
+v.x = 1.5
+v.y = 2
+v.y = v.y + 1
+return v.x, v.y
+)"");
+        REQUIRE(1.5 == lua_tonumber(L, -2));
+        REQUIRE(3 == lua_tonumber(L, -1));
+    }
+
+    SECTION("write only")
+    {
+        luaL_dostring(L, R""(
+local v = Vec2.new()
+v.writes = 5
+return pcall(function() return v.writes end)
+)"");
+        REQUIRE(!lua_toboolean(L, -2));
+        REQUIRE(std::string(lua_tostring(L, -1)).find("'writes' is not found in __index") != std::string::npos);
+    }
+
+    SECTION("unknown key")
+    {
+        luaL_dostring(L, R""(
+local v = Vec2.new()
+return pcall(function() v.z = 1 end)
+)"");
+        REQUIRE(!lua_toboolean(L, -2));
+        REQUIRE(std::string(lua_tostring(L, -1)).find("'z' is not found in __newindex") != std::string::npos);
+    }
+
+    lua_close(L);
+}
+
+TEST_CASE("container index", "[index]")
+{
+    struct Item
+    {
+        int Value = 0;
+    };
+    using ItemList = std::vector<Item>;
+
+    auto L = luaL_newstate();
+    luaL_openlibs(L);
+
+    {
+        static perilune::UserType<Item> itemType;
+        itemType
+            .MetaIndexDispatcher([](auto d) {
+                d->Getter("value", &Item::Value);
+            })
+            .LuaNewType(L);
+        lua_setglobal(L, "Item");
+
+        static perilune::UserType<ItemList *> itemListType;
+        perilune::AddDefaultMethods(itemListType);
+        itemListType
+            .ColonCall()
+            .StaticMethod("New", []() {
+                static ItemList s_list{{1}, {2}, {3}};
+                return &s_list;
+            })
+            .LuaNewType(L);
+        lua_setglobal(L, "ItemList");
+    }
+
+    luaL_dostring(L, R""(
+local list = ItemList.New()
+local sum = 0
+for i = 1, #list do sum = sum + list[i].value end
+return sum, list[0], list[4]
+)"");
+    REQUIRE(6 == lua_tointeger(L, -3));
+    REQUIRE(lua_isnil(L, -2));
+    REQUIRE(lua_isnil(L, -1));
+
+    lua_close(L);
+}
+
+TEST_CASE("interned key slots", "[index]")
+{
+    struct Item
+    {
+        int Value = 1;
+
+        int Twice() const
+        {
+            return Value * 2;
+        }
+    };
+
+    // enough names to share buckets and slots in the KeyTable
+    static std::vector<std::string> s_names = []() {
+        std::vector<std::string> names;
+        for (int i = 0; i < 64; ++i)
+        {
+            names.push_back("f" + std::to_string(i));
+        }
+        return names;
+    }();
+
+    auto L = luaL_newstate();
+    luaL_openlibs(L);
+
+    {
+        static perilune::UserType<Item *> itemType;
+        itemType
+            .DefaultConstructorAndDestructor()
+            .MetaIndexDispatcher([](auto d) {
+                d->Getter("value", &Item::Value);
+                d->Method("twice", &Item::Twice);
+                // setter only
+                d->Setter("write_only", &Item::Value);
+                // long string keys are not interned
+                d->Getter("a_long_name_that_is_not_a_short_string_in_lua", [](Item *p) { return p->Value + 100; });
+                for (int i = 0; i < 64; ++i)
+                {
+                    d->Getter(s_names[i].c_str(), [i](Item *p) { return p->Value + i; });
+                }
+            })
+            .LuaNewType(L);
+        lua_setglobal(L, "Item");
+    }
+
+    SECTION("getter and method")
+    {
+        auto result = luaL_dostring(L, R""(
+local item = Item.new()
+return item.value, item.twice(), item.a_long_name_that_is_not_a_short_string_in_lua
+)"");
+        REQUIRE(LUA_OK == result);
+        REQUIRE(1 == lua_tointeger(L, -3));
+        REQUIRE(2 == lua_tointeger(L, -2));
+        REQUIRE(101 == lua_tointeger(L, -1));
+    }
+
+    SECTION("every slot")
+    {
+        // keys built at runtime are the same interned strings
+        auto result = luaL_dostring(L, R""(
+local item = Item.new()
+for i = 0, 63 do
+    local v = item["f" .. i]
+    if v ~= 1 + i then return false, i end
+end
+return true
+)"");
+        REQUIRE(LUA_OK == result);
+        REQUIRE(lua_toboolean(L, 1));
+    }
+
+    SECTION("miss")
+    {
+        auto result = luaL_dostring(L, R""(
+local item = Item.new()
+local unknown = pcall(function() return item.f64 end)
+local prefix = pcall(function() return item.valu end)
+local writeOnly = pcall(function() return item.write_only end)
+return unknown, prefix, writeOnly
+)"");
+        REQUIRE(LUA_OK == result);
+        REQUIRE(!lua_toboolean(L, -3));
+        REQUIRE(!lua_toboolean(L, -2));
+        REQUIRE(!lua_toboolean(L, -1));
+    }
+
+    lua_close(L);
+}
+
+TEST_CASE("field of a virtual base", "[index]")
+{
+    struct Base
+    {
+        int A = 1;
+    };
+    struct Derived : virtual Base
+    {
+        int B = 2;
+        virtual ~Derived() = default;
+    };
+
+    auto L = luaL_newstate();
+    luaL_openlibs(L);
+
+    {
+        static perilune::UserType<Derived *> derivedType;
+        derivedType
+            .DefaultConstructorAndDestructor()
+            .MetaIndexDispatcher([](auto d) {
+                d->Getter("a", &Derived::A);
+                d->Setter("a", &Derived::A);
+                d->Getter("b", &Derived::B);
+            })
+            .LuaNewType(L);
+        lua_setglobal(L, "Derived");
+    }
+
+    auto result = luaL_dostring(L, R""(
+local d = Derived.new()
+d.a = 10
+return d.a, d.b
+)"");
+    REQUIRE(LUA_OK == result);
+    REQUIRE(10 == lua_tointeger(L, -2));
+    REQUIRE(2 == lua_tointeger(L, -1));
+
+    lua_close(L);
+}
@@ -0,0 +1,62 @@
+#include <catch.hpp>
+#include <perilune/perilune.h>
+
+TEST_CASE("key table", "[keytable]")
+{
+    perilune::KeyTable<int> table;
+    for (int i = 0; i < 100; ++i)
+    {
+        auto key = "key" + std::to_string(i);
+        REQUIRE(table.Insert(key.c_str(), i));
+    }
+    // keep first
+    REQUIRE(!table.Insert("key0", 100));
+
+    // before seal
+    REQUIRE(*table.Find("key50", 5) == 50);
+
+    table.Seal();
+    for (int i = 0; i < 100; ++i)
+    {
+        auto key = "key" + std::to_string(i);
+        auto found = table.Find(key.data(), key.size());
+        REQUIRE(found);
+        REQUIRE(*found == i);
+    }
+
+    REQUIRE(!table.Find("key", 3));
+    REQUIRE(!table.Find("key100", 6));
+    // not null terminated
+    REQUIRE(*table.Find("key10", 4) == 1);
+}
+
+TEST_CASE("key table sizes", "[keytable]")
+{
+    // empty
+    perilune::KeyTable<int> empty;
+    empty.Seal();
+    REQUIRE(!empty.Find("key", 3));
+
+    perilune::KeyTable<int> one;
+    one.Insert("x", 1);
+    one.Seal();
+    REQUIRE(*one.Find("x", 1) == 1);
+    REQUIRE(!one.Find("y", 1));
+
+    // one slot per key
+    perilune::KeyTable<int> table;
+    for (int i = 0; i < 5000; ++i)
+    {
+        auto key = "name_" + std::to_string(i);
+        table.Insert(key.c_str(), i);
+    }
+    table.Seal();
+    for (int i = 0; i < 5000; ++i)
+    {
+        auto key = "name_" + std::to_string(i);
+        auto found = table.Find(key.data(), key.size());
+        REQUIRE(found);
+        REQUIRE(*found == i);
+    }
+    REQUIRE(!table.Find("name_5000", 9));
+}
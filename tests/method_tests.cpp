@@ -0,0 +1,321 @@
+#include <catch.hpp>
+#include <perilune/perilune.h>
+
+namespace
+{
+
+struct Point
+{
+    int X = 0;
+    int Y = 0;
+
+    void Move(int x, int y)
+    {
+        X += x;
+        Y += y;
+    }
+
+    int Sum() const
+    {
+        return X + Y;
+    }
+};
+
+Point *NewPoint(int x, int y)
+{
+    auto p = new Point;
+    p->X = x;
+    p->Y = y;
+    return p;
+}
+
+} // namespace
+
+TEST_CASE("cache bound methods", "[method]")
+{
+    struct Counter
+    {
+        int Value = 0;
+
+        int Next()
+        {
+            return ++Value;
+        }
+    };
+
+    auto L = luaL_newstate();
+    luaL_openlibs(L);
+
+    {
+        static perilune::UserType<Counter *> counterType;
+        counterType
+            .DefaultConstructorAndDestructor()
+            .CacheBoundMethods()
+            .MetaIndexDispatcher([](auto d) {
+                d->Method("next", &Counter::Next);
+            })
+            .LuaNewType(L);
+        lua_setglobal(L, "Counter");
+    }
+
+    luaL_dostring(L, R""(
+local a = Counter.new()
+local b = Counter.new()
+a.next()
+a.next()
+return a.next == a.next, a.next ~= b.next, a.next(), b.next()
+)"");
+
+    REQUIRE(lua_toboolean(L, -4));
+    REQUIRE(lua_toboolean(L, -3));
+    REQUIRE(3 == lua_tointeger(L, -2));
+    REQUIRE(1 == lua_tointeger(L, -1));
+
+    lua_close(L);
+}
+
+TEST_CASE("colon call", "[method]")
+{
+    struct Counter
+    {
+        int Value = 0;
+
+        int Add(int n)
+        {
+            Value += n;
+            return Value;
+        }
+
+        int Get() const
+        {
+            return Value;
+        }
+    };
+
+    struct Accumulator
+    {
+        int Value = 0;
+
+        void Add(int n)
+        {
+            Value += n;
+        }
+    };
+
+    auto L = luaL_newstate();
+    luaL_openlibs(L);
+
+    {
+        static perilune::UserType<Counter *> counterType;
+        counterType
+            .DefaultConstructorAndDestructor()
+            .ColonCall()
+            .MetaIndexDispatcher([](auto d) {
+                d->Method("add", &Counter::Add);
+                d->Method("get", &Counter::Get);
+                d->Method("twice", [](Counter *self, int n) {
+                    return self->Add(n * 2);
+                });
+            })
+            .LuaNewType(L);
+        lua_setglobal(L, "Counter");
+    }
+
+    {
+        static perilune::UserType<Accumulator *> accumulatorType;
+        accumulatorType
+            .DefaultConstructorAndDestructor()
+            .ColonCall()
+            .MetaIndexDispatcher([](auto d) {
+                d->Method("add", &Accumulator::Add);
+                d->Getter("value", &Accumulator::Value);
+            })
+            .LuaNewType(L);
+        lua_setglobal(L, "Accumulator");
+    }
+
+    luaL_dostring(L, R""(
+local a = Counter.new()
+a:add(1)
+a:twice(2)
+local b = Accumulator.new()
+b:add(3)
+return type(getmetatable(a).__index), a:get(), b.value
+)"");
+
+    REQUIRE(std::string("table") == lua_tostring(L, -3));
+    REQUIRE(5 == lua_tointeger(L, -2));
+    REQUIRE(3 == lua_tointeger(L, -1));
+
+    lua_close(L);
+}
+
+TEST_CASE("compile time method", "[method]")
+{
+    auto L = luaL_newstate();
+    luaL_openlibs(L);
+
+    {
+        static perilune::UserType<Point *> pointType;
+        pointType
+            .StaticMethod<&NewPoint>("new")
+            .MetaMethod(perilune::MetaKey::__gc, [](Point *p) { delete p; })
+            .MetaIndexDispatcher([](perilune::IndexDispatcher<Point *> *d) {
+                d->Method<&Point::Move>("move");
+                d->Method<&Point::Sum>("sum");
+            })
+            .LuaNewType(L);
+        lua_setglobal(L, "Point");
+    }
+
+    luaL_dostring(L, R""(
+local p = Point.new(1, 2)
+p.move(3, 4)
+return p.sum()
+)"");
+
+    REQUIRE(10 == lua_tointeger(L, -1));
+
+    lua_close(L);
+}
+
+TEST_CASE("compile time method colon call", "[method]")
+{
+    auto L = luaL_newstate();
+    luaL_openlibs(L);
+
+    {
+        static perilune::UserType<Point *> pointType;
+        pointType
+            .StaticMethod<&NewPoint>("new")
+            .MetaMethod(perilune::MetaKey::__gc, [](Point *p) { delete p; })
+            .ColonCall()
+            .MetaIndexDispatcher([](perilune::IndexDispatcher<Point *> *d) {
+                d->Method<&Point::Move>("move");
+                d->Method<&Point::Sum>("sum");
+            })
+            .LuaNewType(L);
+        lua_setglobal(L, "Point");
+    }
+
+    luaL_dostring(L, R""(
+local p = Point.new(1, 2)
+p:move(3, 4)
+return p:sum()
+)"");
+
+    REQUIRE(10 == lua_tointeger(L, -1));
+
+    lua_close(L);
+}
+
+TEST_CASE("multiple return values", "[method]")
+{
+    struct Size
+    {
+        int Width = 0;
+        int Height = 0;
+
+        std::tuple<bool, int, int> Get() const
+        {
+            return {Width > 0 && Height > 0, Width, Height};
+        }
+
+        std::pair<int, std::string> Area()
+        {
+            return {Width * Height, "px"};
+        }
+    };
+
+    auto L = luaL_newstate();
+    luaL_openlibs(L);
+
+    {
+        static perilune::UserType<Size *> sizeType;
+        sizeType
+            .DefaultConstructorAndDestructor()
+            .StaticMethod("divmod", [](int a, int b) { return std::make_tuple(a / b, a % b); })
+            .StaticMethod("nested", [](int a) {
+                return std::make_tuple(a, std::make_pair(a + 1, std::make_tuple(a + 2, a + 3)), a + 4);
+            })
+            .MetaIndexDispatcher([](auto d) {
+                d->Setter("width", &Size::Width);
+                d->Setter("height", &Size::Height);
+                d->Method("get", &Size::Get);
+                d->Method("area", &Size::Area);
+                d->template Method<&Size::Get>("get_thunk");
+            })
+            .LuaNewType(L);
+        lua_setglobal(L, "Size");
+    }
+
+    auto result = luaL_dostring(L, R""(
+local s = Size.new()
+s.width = 3
+s.height = 2
+local ok, w, h = s.get()
+local ok2, w2, h2 = s.get_thunk()
+local area, unit = s.area()
+local q, r = Size.divmod(7, 2)
+return ok and ok2, w + w2, h + h2, area, unit, q, r, select('#', s.get())
+)"");
+    REQUIRE(LUA_OK == result);
+    REQUIRE(lua_toboolean(L, -8));
+    REQUIRE(6 == lua_tointeger(L, -7));
+    REQUIRE(4 == lua_tointeger(L, -6));
+    REQUIRE(6 == lua_tointeger(L, -5));
+    REQUIRE(std::string("px") == lua_tostring(L, -4));
+    REQUIRE(3 == lua_tointeger(L, -3));
+    REQUIRE(1 == lua_tointeger(L, -2));
+    REQUIRE(3 == lua_tointeger(L, -1));
+    lua_settop(L, 0);
+
+    // nested tuple and pair are flattened
+    result = luaL_dostring(L, R""(
+local n = select('#', Size.nested(1))
+local a, b, c, d, e = Size.nested(1)
+return n, a + b * 10 + c * 100 + d * 1000 + e * 10000
+)"");
+    REQUIRE(LUA_OK == result);
+    REQUIRE(5 == lua_tointeger(L, -2));
+    REQUIRE(54321 == lua_tointeger(L, -1));
+
+    lua_close(L);
+}
+
+TEST_CASE("void metamethod", "[method]")
+{
+    struct Item
+    {
+        int Value = 0;
+    };
+    static int s_called = 0;
+
+    auto L = luaL_newstate();
+    luaL_openlibs(L);
+
+    {
+        static perilune::UserType<Item> itemType;
+        itemType
+            .StaticMethod("new", [](int n) {
+                Item item;
+                item.Value = n;
+                return item;
+            })
+            // the first argument is not RawType *
+            .MetaMethod(perilune::MetaKey::__call, [](const Item &self, int n) {
+                s_called = self.Value + n;
+            })
+            .LuaNewType(L);
+        lua_setglobal(L, "Item");
+    }
+
+    auto result = luaL_dostring(L, R""(
+local item = Item.new(1)
+item(2)
+)"");
+    REQUIRE(LUA_OK == result);
+    REQUIRE(3 == s_called);
+
+    lua_close(L);
+}
@@ -0,0 +1,171 @@
+#include <catch.hpp>
+#include <perilune/perilune.h>
+
+TEST_CASE("object pool", "[pool]")
+{
+    struct Counted
+    {
+        int *Count;
+        Counted(int *count)
+            : Count(count)
+        {
+            ++*Count;
+        }
+        ~Counted()
+        {
+            --*Count;
+        }
+    };
+
+    int count = 0;
+    perilune::ObjectPool<Counted> pool(2);
+    REQUIRE(0 == pool.Live());
+    REQUIRE(2 == pool.Free());
+
+    auto a = pool.New(&count);
+    auto b = pool.New(&count);
+    REQUIRE(2 == count);
+    REQUIRE(0 == pool.Free());
+
+    // grows by a slab
+    auto c = pool.New(&count);
+    REQUIRE(3 == pool.Live());
+    REQUIRE(4 == pool.Capacity());
+
+    // recycled
+    pool.Delete(b);
+    REQUIRE(2 == count);
+    auto d = pool.New(&count);
+    REQUIRE(b == d);
+
+    // not from the pool
+    Counted outside(&count);
+    pool.Delete(&outside);
+    REQUIRE(3 == pool.Live());
+
+    pool.Delete(a);
+    pool.Delete(c);
+    pool.Delete(d);
+    REQUIRE(0 == pool.Live());
+
+    // deleted twice. the slot is not freed again
+    pool.Delete(a);
+    REQUIRE(0 == pool.Live());
+    auto e = pool.New(&count);
+    auto f = pool.New(&count);
+    REQUIRE(e != f);
+    pool.Delete(e);
+    pool.Delete(f);
+    REQUIRE(4 == pool.Free());
+    REQUIRE(1 == count);
+}
+
+TEST_CASE("object pool contains", "[pool]")
+{
+    struct Item
+    {
+        int Value[3];
+    };
+
+    // 64 slabs of 3
+    perilune::ObjectPool<Item> pool(3);
+    std::vector<Item *> items;
+    for (int i = 0; i < 64 * 3; ++i)
+    {
+        items.push_back(pool.New());
+    }
+    REQUIRE(64 * 3 == pool.Capacity());
+    for (auto p : items)
+    {
+        REQUIRE(pool.Contains(p));
+    }
+
+    // not a slot
+    auto inside = reinterpret_cast<Item *>(reinterpret_cast<char *>(items[0]) + sizeof(int));
+    REQUIRE(!pool.Contains(inside));
+    Item outside;
+    REQUIRE(!pool.Contains(&outside));
+    pool.Delete(&outside);
+    REQUIRE(64 * 3 == pool.Live());
+
+    for (auto p : items)
+    {
+        pool.Delete(p);
+    }
+    REQUIRE(0 == pool.Live());
+}
+
+TEST_CASE("pooled usertype", "[pool]")
+{
+    struct Vec2
+    {
+        float X = 0;
+        float Y = 0;
+    };
+
+    auto L = luaL_newstate();
+    luaL_openlibs(L);
+
+    static perilune::UserType<Vec2 *> vec2Type;
+    vec2Type
+        .Pooled(64)
+        .StaticMethod("same", [](Vec2 *v) { return v; })
+        .MetaIndexDispatcher([](auto d) {
+            d->Getter("x", &Vec2::X);
+            d->Setter("x", &Vec2::X);
+        })
+        .LuaNewType(L);
+    lua_setglobal(L, "Vec2");
+
+    auto pool = vec2Type.Pool();
+    REQUIRE(pool);
+
+    auto result = luaL_dostring(L, R""(
+list = {}
+for i = 1, 100 do
+    local v = Vec2.new()
+    v.x = i
+    list[i] = v
+end
+return list[100].x
+)"");
+    REQUIRE(LUA_OK == result);
+    REQUIRE(100 == lua_tonumber(L, -1));
+    lua_pop(L, 1);
+    REQUIRE(100 == pool->Live());
+    REQUIRE(128 == pool->Capacity());
+
+    // __gc returns the slots
+    luaL_dostring(L, "list = nil");
+    lua_gc(L, LUA_GCCOLLECT, 0);
+    REQUIRE(0 == pool->Live());
+
+    // no new slab
+    luaL_dostring(L, R""(
+for i = 1, 100 do Vec2.new() end
+collectgarbage()
+)"");
+    REQUIRE(128 == pool->Capacity());
+
+    // the same pointer in two userdata. the second __gc is ignored
+    result = luaL_dostring(L, R""(
+local a = Vec2.new()
+local b = Vec2.same(a)
+a = nil
+b = nil
+collectgarbage()
+local x = Vec2.new()
+local y = Vec2.new()
+x.x = 1
+y.x = 2
+return x.x
+)"");
+    REQUIRE(LUA_OK == result);
+    REQUIRE(1 == lua_tonumber(L, -1));
+    lua_pop(L, 1);
+    lua_gc(L, LUA_GCCOLLECT, 0);
+    REQUIRE(0 == pool->Live());
+
+    lua_close(L);
+    REQUIRE(0 == pool->Live());
+}
@@ -56,4 +56,52 @@ local s = Shared.new(2)
 
     REQUIRE(1 == s_new);
     REQUIRE(1 == s_dest);
-}
\ No newline at end of file
+}
+
+TEST_CASE("mixed holder", "[shared_ptr]")
+{
+    struct Item
+    {
+        int Value = 0;
+    };
+
+    auto L = luaL_newstate();
+    luaL_openlibs(L);
+
+    {
+        static perilune::UserType<std::shared_ptr<Item>> sharedType;
+        sharedType
+            .StaticMethod("new", [](int n) {
+                auto p = std::make_shared<Item>();
+                p->Value = n;
+                return p;
+            })
+            // takes a raw pointer and a reference
+            .StaticMethod("sum", [](Item *a, const Item &b) {
+                return a->Value + b.Value;
+            })
+            .LuaNewType(L);
+        lua_setglobal(L, "SharedItem");
+
+        static perilune::UserType<Item> valueType;
+        valueType
+            .StaticMethod("new", [](int n) {
+                Item item;
+                item.Value = n;
+                return item;
+            })
+            .LuaNewType(L);
+        lua_setglobal(L, "Item");
+    }
+
+    auto result = luaL_dostring(L, R""(
+local a = SharedItem.new(1)
+local b = Item.new(2)
+return SharedItem.sum(a, b), SharedItem.sum(b, a)
+)"");
+    REQUIRE(LUA_OK == result);
+    REQUIRE(3 == lua_tointeger(L, -2));
+    REQUIRE(3 == lua_tointeger(L, -1));
+
+    lua_close(L);
+}
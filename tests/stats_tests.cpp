@@ -0,0 +1,82 @@
+#include <catch.hpp>
+#include <perilune/perilune.h>
+#include <string.h>
+
+// built with PERILUNE_STATS. see tests/CMakeLists.txt
+
+TEST_CASE("usertype stats", "[stats]")
+{
+    struct Vector3
+    {
+        float x = 0;
+        float y = 0;
+        float z = 0;
+    };
+
+    struct Node
+    {
+        int Value = 0;
+    };
+
+    auto L = luaL_newstate();
+    luaL_openlibs(L);
+    perilune::LuaOpenStats(L);
+
+    static perilune::UserType<Vector3> vector3Type;
+    vector3Type
+        .StaticMethod("new", []() { return Vector3{}; })
+        .LuaNewType(L);
+    lua_setglobal(L, "Vector3");
+
+    static perilune::UserType<Node *> nodeType;
+    nodeType
+        .DefaultConstructorAndDestructor()
+        .LuaNewType(L);
+    lua_setglobal(L, "Node");
+
+    auto &vector3Stats = vector3Type.Stats();
+    auto &nodeStats = nodeType.Stats();
+
+    auto result = luaL_dostring(L, R""(
+list = {}
+for i = 1, 100 do list[i] = Vector3.new() end
+nodes = {}
+for i = 1, 10 do nodes[i] = Node.new() end
+)"");
+    REQUIRE(LUA_OK == result);
+    REQUIRE(100 == vector3Stats.Live);
+    REQUIRE(100 * (perilune::UserDataOffset<Vector3>() + sizeof(Vector3)) == vector3Stats.Bytes);
+    REQUIRE(10 == nodeStats.Live);
+
+    SECTION("lua")
+    {
+        // sorted by bytes
+        result = luaL_dostring(L, R""(
+local s = perilune.stats(1)
+return #s, s[1].live, s[1].bytes
+)"");
+        REQUIRE(LUA_OK == result);
+        REQUIRE(1 == lua_tointeger(L, -3));
+        REQUIRE(100 == lua_tointeger(L, -2));
+        REQUIRE(vector3Stats.Bytes == lua_tointeger(L, -1));
+        lua_pop(L, 3);
+
+        auto report = perilune::HeapReport(1);
+        REQUIRE(report.find(typeid(Vector3).name()) != std::string::npos);
+    }
+
+    SECTION("gc")
+    {
+        luaL_dostring(L, "list = nil nodes[1] = nil");
+        lua_gc(L, LUA_GCCOLLECT, 0);
+        REQUIRE(0 == vector3Stats.Live);
+        REQUIRE(0 == vector3Stats.Bytes);
+        REQUIRE(100 == vector3Stats.PeakLive);
+        // __gc of DefaultConstructorAndDestructor is counted
+        REQUIRE(9 == nodeStats.Live);
+    }
+
+    lua_close(L);
+    REQUIRE(0 == vector3Stats.Live);
+    REQUIRE(0 == nodeStats.Live);
+}
@@ -0,0 +1,59 @@
+#include <catch.hpp>
+#include <perilune/perilune.h>
+#include <string_view>
+
+TEST_CASE("string", "[string]")
+{
+    struct Strings
+    {
+    };
+
+    auto L = luaL_newstate();
+    luaL_openlibs(L);
+
+    static const char *s_pointer = nullptr;
+
+    {
+        static perilune::UserType<Strings *> stringsType;
+        stringsType
+            .StaticMethod("view", [](std::string_view s) {
+                s_pointer = s.data();
+                return s.size();
+            })
+            .StaticMethod("cstr", [](const char *s) {
+                s_pointer = s;
+                return std::string_view(s).size();
+            })
+            .StaticMethod("echo", [](const std::string &s) { return s; })
+            .StaticMethod("head", [](std::string_view s) { return s.substr(0, 2); })
+            .StaticMethod("name", []() { return "perilune"; })
+            .LuaNewType(L);
+        lua_setglobal(L, "Strings");
+    }
+
+    SECTION("view")
+    {
+        lua_pushstring(L, "hello");
+        lua_setglobal(L, "s");
+        luaL_dostring(L, "return Strings.view(s), Strings.cstr(s)");
+        REQUIRE(5 == lua_tointeger(L, -2));
+        REQUIRE(5 == lua_tointeger(L, -1));
+
+        // points the lua string
+        lua_getglobal(L, "s");
+        REQUIRE(s_pointer == lua_tostring(L, -1));
+    }
+
+    SECTION("embedded zero")
+    {
+        luaL_dostring(L, R""(return Strings.echo('a\0b'), Strings.view('a\0b'), Strings.head('abc'), Strings.name())"");
+        size_t len;
+        auto str = lua_tolstring(L, -4, &len);
+        REQUIRE(std::string("a\0b", 3) == std::string(str, len));
+        REQUIRE(3 == lua_tointeger(L, -3));
+        REQUIRE(std::string("ab") == lua_tostring(L, -2));
+        REQUIRE(std::string("perilune") == lua_tostring(L, -1));
+    }
+
+    lua_close(L);
+}
@@ -0,0 +1,93 @@
+#include <catch.hpp>
+#include <perilune/perilune.h>
+#include <numeric>
+
+TEST_CASE("vector and array", "[table]")
+{
+    auto L = luaL_newstate();
+    luaL_openlibs(L);
+
+    {
+        struct Table
+        {
+        };
+        static perilune::UserType<Table *> tableType;
+        tableType
+            .StaticMethod("sum", [](const std::vector<float> &values) {
+                return std::accumulate(values.begin(), values.end(), 0.0f);
+            })
+            .StaticMethod("names", [](std::vector<std::string> names) {
+                std::string joined;
+                for (auto &name : names)
+                {
+                    joined += name;
+                }
+                return joined;
+            })
+            .StaticMethod("range", [](int n) {
+                std::vector<int> values(n);
+                std::iota(values.begin(), values.end(), 1);
+                return values;
+            })
+            .StaticMethod("nested", []() {
+                return std::vector<std::vector<int>>{{1, 2}, {3}};
+            })
+            .StaticMethod("reverse", [](std::array<float, 3> a) {
+                return std::array<float, 3>{a[2], a[1], a[0]};
+            })
+            .LuaNewType(L);
+        lua_setglobal(L, "Table");
+    }
+
+    SECTION("get")
+    {
+        auto result = luaL_dostring(L, R""(
+return Table.sum({1, 2, 3.5}), Table.names({"a", "b", "c"}), Table.sum({})
+)"");
+        REQUIRE(LUA_OK == result);
+        REQUIRE(6.5 == lua_tonumber(L, -3));
+        REQUIRE(std::string("abc") == lua_tostring(L, -2));
+        REQUIRE(0 == lua_tonumber(L, -1));
+    }
+
+    SECTION("push")
+    {
+        auto result = luaL_dostring(L, R""(
+local r = Table.range(3)
+local n = Table.nested()
+return #r, r[1], r[3], math.type(r[1]), #n, n[1][2], n[2][1]
+)"");
+        REQUIRE(LUA_OK == result);
+        REQUIRE(3 == lua_tointeger(L, -7));
+        REQUIRE(1 == lua_tointeger(L, -6));
+        REQUIRE(3 == lua_tointeger(L, -5));
+        REQUIRE(std::string("integer") == lua_tostring(L, -4));
+        REQUIRE(2 == lua_tointeger(L, -3));
+        REQUIRE(2 == lua_tointeger(L, -2));
+        REQUIRE(3 == lua_tointeger(L, -1));
+    }
+
+    SECTION("array")
+    {
+        auto result = luaL_dostring(L, R""(
+local a = Table.reverse({1, 2, 3})
+return #a, a[1], a[3], pcall(Table.reverse, {1, 2})
+)"");
+        REQUIRE(LUA_OK == result);
+        REQUIRE(3 == lua_tointeger(L, -5));
+        REQUIRE(3 == lua_tonumber(L, -4));
+        REQUIRE(1 == lua_tonumber(L, -3));
+        REQUIRE(!lua_toboolean(L, -2));
+    }
+
+    SECTION("element error")
+    {
+        auto result = luaL_dostring(L, R""(
+return pcall(Table.sum, {1, "x"})
+)"");
+        REQUIRE(LUA_OK == result);
+        REQUIRE(!lua_toboolean(L, -2));
+    }
+
+    lua_close(L);
+}
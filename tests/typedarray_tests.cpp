@@ -0,0 +1,139 @@
+#include <catch.hpp>
+#include <perilune/perilune.h>
+#include <numeric>
+
+TEST_CASE("typed array", "[typedarray]")
+{
+    using FloatArray = perilune::TypedArray<float>;
+
+    auto L = luaL_newstate();
+    luaL_openlibs(L);
+
+    {
+        static perilune::UserType<FloatArray> floatArrayType;
+        perilune::AddTypedArrayMethods(floatArrayType);
+        floatArrayType
+            .StaticMethod("sum", [](std::span<const float> values) {
+                return std::accumulate(values.begin(), values.end(), 0.0f);
+            })
+            .StaticMethod("fill", [](std::span<float> values, float value) {
+                for (auto &v : values)
+                {
+                    v = value;
+                }
+            })
+            .LuaNewType(L);
+        lua_setglobal(L, "FloatArray");
+    }
+
+    SECTION("get set")
+    {
+        auto result = luaL_dostring(L, R""(
+local a = FloatArray.new(4)
+for i = 1, #a do a[i] = i * 0.5 end
+return #a, a[1], a[4], a[5], FloatArray.sum(a)
+)"");
+        REQUIRE(LUA_OK == result);
+        REQUIRE(4 == lua_tointeger(L, -5));
+        REQUIRE(0.5 == lua_tonumber(L, -4));
+        REQUIRE(2.0 == lua_tonumber(L, -3));
+        REQUIRE(lua_isnil(L, -2));
+        REQUIRE(5.0 == lua_tonumber(L, -1));
+    }
+
+    SECTION("slice")
+    {
+        auto result = luaL_dostring(L, R""(
+local a = FloatArray.new(4)
+local s = a.slice(2, 2)
+FloatArray.fill(s, 3)
+s[2] = 7
+return #s, a[1], a[2], a[3], a[4]
+)"");
+        REQUIRE(LUA_OK == result);
+        REQUIRE(2 == lua_tointeger(L, -5));
+        REQUIRE(0 == lua_tonumber(L, -4));
+        REQUIRE(3 == lua_tonumber(L, -3));
+        REQUIRE(7 == lua_tonumber(L, -2));
+        REQUIRE(0 == lua_tonumber(L, -1));
+    }
+
+    SECTION("resize")
+    {
+        auto result = luaL_dostring(L, R""(
+local a = FloatArray.new(2)
+a[2] = 1
+a.resize(3)
+a[3] = 2
+local ok = pcall(function() a.slice(1, 2).resize(4) end)
+return #a, a[2], a[3], ok
+)"");
+        REQUIRE(LUA_OK == result);
+        REQUIRE(3 == lua_tointeger(L, -4));
+        REQUIRE(1 == lua_tonumber(L, -3));
+        REQUIRE(2 == lua_tonumber(L, -2));
+        REQUIRE(!lua_toboolean(L, -1));
+    }
+
+    SECTION("views after resize")
+    {
+        auto result = luaL_dostring(L, R""(
+local a = FloatArray.new(8)
+local s = a.slice(5, 4)
+a.resize(2)
+local sliceWrite = pcall(function() s[1] = 1 end)
+
+local b = FloatArray.new(4)
+local full = b.slice(1, #b)
+full.resize(1)
+local parentWrite = pcall(function() b[2] = 1 end)
+
+local negative = pcall(function() FloatArray.new(-1) end)
+
+-- copy from and to the stale views
+local c = FloatArray.new(8)
+assert(c.copy(s) == 0 and s.copy(c) == 0 and full.copy(c) == 1)
+return #s, s[1], FloatArray.sum(s), sliceWrite, #b, b[2], parentWrite, negative
+)"");
+        REQUIRE(LUA_OK == result);
+        REQUIRE(0 == lua_tointeger(L, -8));
+        REQUIRE(lua_isnil(L, -7));
+        REQUIRE(0 == lua_tonumber(L, -6));
+        REQUIRE(!lua_toboolean(L, -5));
+        REQUIRE(1 == lua_tointeger(L, -4));
+        REQUIRE(lua_isnil(L, -3));
+        REQUIRE(!lua_toboolean(L, -2));
+        REQUIRE(!lua_toboolean(L, -1));
+    }
+
+    SECTION("copy")
+    {
+        auto result = luaL_dostring(L, R""(
+local a = FloatArray.new(4)
+for i = 1, #a do a[i] = i end
+local b = FloatArray.new(2)
+local n = b.copy(a)
+-- overlapping slices
+a.slice(2, 3).copy(a.slice(1, 3))
+return n, b[2], a[1], a[2], a[4]
+)"");
+        REQUIRE(LUA_OK == result);
+        REQUIRE(2 == lua_tointeger(L, -5));
+        REQUIRE(2 == lua_tonumber(L, -4));
+        REQUIRE(1 == lua_tonumber(L, -3));
+        REQUIRE(1 == lua_tonumber(L, -2));
+        REQUIRE(3 == lua_tonumber(L, -1));
+    }
+
+    SECTION("out of range")
+    {
+        auto result = luaL_dostring(L, R""(
+local a = FloatArray.new(2)
+return pcall(function() a[3] = 1 end)
+)"");
+        REQUIRE(LUA_OK == result);
+        REQUIRE(!lua_toboolean(L, -2));
+    }
+
+    lua_close(L);
+}
@@ -0,0 +1,61 @@
+#include <catch.hpp>
+#include <perilune/perilune.h>
+
+TEST_CASE("userdata header", "[userdata]")
+{
+    struct Foo
+    {
+        int Value = 1;
+    };
+    struct Bar
+    {
+        double Value = 2;
+    };
+
+    auto L = luaL_newstate();
+
+    static perilune::UserType<Foo> fooType;
+    fooType.LuaNewType(L);
+    lua_pop(L, 1);
+    static perilune::UserType<Bar> barType;
+    barType.LuaNewType(L);
+    lua_pop(L, 1);
+
+    REQUIRE(perilune::TypeId<Foo>() != perilune::TypeId<Bar>());
+    REQUIRE(perilune::TypeId<Foo>() == perilune::TypeId<const Foo>());
+
+    perilune::LuaPush<Foo>::Push(L, Foo{});
+    perilune::LuaPush<Bar>::Push(L, Bar{});
+
+    REQUIRE(perilune::LuaCheckUserData<Foo>(L, -2)->Value == 1);
+    REQUIRE(!perilune::LuaCheckUserData<Bar>(L, -2));
+    REQUIRE(perilune::LuaCheckUserData<Bar>(L, -1)->Value == 2);
+    REQUIRE(!perilune::LuaCheckUserData<Foo>(L, -1));
+    // holder kind
+    REQUIRE(!perilune::LuaCheckUserData<Foo *>(L, -2));
+    REQUIRE(perilune::LuaToRaw<Foo>(L, -2)->Value == 1);
+    REQUIRE(!perilune::LuaToRaw<Bar>(L, -2));
+    lua_pop(L, 2);
+
+    // foreign userdata falls back to the metatable
+    auto foreign = (Foo *)lua_newuserdata(L, sizeof(Foo));
+    foreign->Value = 3;
+    perilune::LuaGetMetatable<Foo>(L);
+    lua_setmetatable(L, -2);
+    REQUIRE(perilune::LuaCheckUserData<Foo>(L, -1) == foreign);
+    REQUIRE(!perilune::LuaCheckUserData<Bar>(L, -1));
+    lua_pop(L, 1);
+
+    // foreign bytes that look like a 16 bit magic and a holder are not a header
+    auto bytes = static_cast<uint8_t *>(lua_newuserdata(L, 32));
+    memset(bytes, 0, 32);
+    bytes[0] = 0x50;
+    bytes[1] = 0x52;
+    bytes[2] = static_cast<uint8_t>(perilune::UserDataHolder::Pointer);
+    auto typeId = perilune::TypeId<Foo>();
+    memcpy(bytes + 4, &typeId, sizeof(typeId));
+    REQUIRE(!perilune::LuaToRaw<Foo>(L, -1));
+    REQUIRE(!perilune::LuaCheckUserData<Foo *>(L, -1));
+
+    lua_close(L);
+}
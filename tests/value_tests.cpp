@@ -51,13 +51,17 @@ local id = value.id
 
 )"");
 
+    // trivially destructible. no finalizer
+    REQUIRE(perilune::LuaGetMetatable<Value>(L));
+    REQUIRE(LUA_TNIL == lua_getfield(L, -1, "__gc"));
+    lua_pop(L, 2);
+
     lua_close(L);
 
     // new in static method
-    // placement new for userdata
-    // copy to userdata from static method return
-    REQUIRE(2 == s_new);
-    REQUIRE(1 == s_copy);
+    // the return value is constructed in the userdata
+    REQUIRE(1 == s_new);
+    REQUIRE(0 == s_copy);
 }
 
 TEST_CASE("placement new", "[value]")
@@ -110,6 +114,11 @@ local id = value.id
 
 )"");
 
+    // trivially destructible. no finalizer
+    REQUIRE(perilune::LuaGetMetatable<Value>(L));
+    REQUIRE(LUA_TNIL == lua_getfield(L, -1, "__gc"));
+    lua_pop(L, 2);
+
     lua_close(L);
 
     // new in static method
@@ -184,4 +193,434 @@ return Value.get(value)
 
     REQUIRE(0 == s_copy);
     REQUIRE(1 == s_dest);
-}
\ No newline at end of file
+}
+
+namespace
+{
+
+int s_temporaryNew = 0;
+int s_temporaryCopy = 0;
+
+struct Temporary
+{
+    int N = 0;
+
+    Temporary(int n)
+        : N(n)
+    {
+        ++s_temporaryNew;
+    }
+
+    Temporary(const Temporary &rhs)
+        : N(rhs.N)
+    {
+        ++s_temporaryCopy;
+    }
+
+    Temporary &operator=(const Temporary &rhs)
+    {
+        ++s_temporaryCopy;
+        N = rhs.N;
+        return *this;
+    }
+
+    Temporary Twice() const
+    {
+        return Temporary(N * 2);
+    }
+
+    static Temporary Make(int n)
+    {
+        return Temporary(n);
+    }
+
+    int Dot(const Temporary &rhs) const
+    {
+        return N * rhs.N;
+    }
+
+    static int Sum(const Temporary &a, const Temporary &b)
+    {
+        return a.N + b.N;
+    }
+
+    static void Increment(Temporary &t)
+    {
+        ++t.N;
+    }
+};
+
+} // namespace
+
+TEST_CASE("return temporary", "[value]")
+{
+    auto L = luaL_newstate();
+    luaL_openlibs(L);
+
+    {
+        static perilune::UserType<Temporary> valueType;
+        valueType
+            .StaticMethod("new", [](int n) { return Temporary(n); })
+            .StaticMethod<&Temporary::Make>("make")
+            .MetaMethod(perilune::MetaKey::__add, [](Temporary *a, Temporary *b) {
+                return Temporary(a->N + b->N);
+            })
+            .MetaIndexDispatcher([](perilune::IndexDispatcher<Temporary> *d) {
+                d->Getter("n", [](Temporary *v) { return v->N; });
+                d->Method("twice", &Temporary::Twice);
+                d->Getter("half", [](Temporary *v) { return Temporary(v->N / 2); });
+            })
+            .LuaNewType(L);
+        lua_setglobal(L, "Value");
+    }
+
+    auto result = luaL_dostring(L, R""(
+local a = Value.new(1)
+local b = Value.make(2)
+local c = a + b
+local d = c.twice()
+local e = d.half
+return e.n
+)"");
+    REQUIRE(LUA_OK == result);
+    REQUIRE(3 == lua_tointeger(L, -1));
+
+    lua_close(L);
+
+    REQUIRE(5 == s_temporaryNew);
+    REQUIRE(0 == s_temporaryCopy);
+}
+
+TEST_CASE("reference argument", "[value]")
+{
+    s_temporaryNew = 0;
+    s_temporaryCopy = 0;
+
+    auto L = luaL_newstate();
+    luaL_openlibs(L);
+
+    {
+        static perilune::UserType<Temporary> valueType;
+        valueType
+            .StaticMethod("new", [](int n) { return Temporary(n); })
+            .StaticMethod("sum", [](const Temporary &a, const Temporary &b) { return a.N + b.N; })
+            .StaticMethod<&Temporary::Sum>("sum_thunk")
+            .StaticMethod<&Temporary::Increment>("increment")
+            .MetaMethod(perilune::MetaKey::__concat, [](Temporary *a, const Temporary &b) {
+                return a->N - b.N;
+            })
+            .MetaIndexDispatcher([](perilune::IndexDispatcher<Temporary> *d) {
+                d->Getter("n", [](Temporary *v) { return v->N; });
+                d->Method("dot", &Temporary::Dot);
+                d->Method<&Temporary::Dot>("dot_thunk");
+                d->Method("dot_lambda", [](Temporary *self, const Temporary &rhs) { return self->N * rhs.N; });
+            })
+            .LuaNewType(L);
+        lua_setglobal(L, "Temporary");
+    }
+
+    auto result = luaL_dostring(L, R""(
+local a = Temporary.new(2)
+local b = Temporary.new(3)
+Temporary.increment(b)
+return Temporary.sum(a, b) + Temporary.sum_thunk(a, b) + (b .. a) + a.dot(b) + a.dot_thunk(b) + a.dot_lambda(b)
+)"");
+    REQUIRE(LUA_OK == result);
+    // 6 + 6 + 2 + 8 + 8 + 8
+    REQUIRE(38 == lua_tointeger(L, -1));
+
+    lua_close(L);
+
+    REQUIRE(2 == s_temporaryNew);
+    REQUIRE(0 == s_temporaryCopy);
+}
+
+namespace
+{
+
+struct Point
+{
+    float x = 0;
+    float y = 0;
+    float z = 0;
+};
+
+} // namespace
+
+TEST_CASE("struct table", "[value]")
+{
+    auto L = luaL_newstate();
+    luaL_openlibs(L);
+
+    {
+        static perilune::UserType<Point> pointType;
+        pointType
+            .StaticMethod("sum", [](Point p) { return p.x + p.y + p.z; })
+            .StaticMethod("z", [](const Point &p) { return p.z; })
+            .MetaIndexDispatcher([](perilune::IndexDispatcher<Point> *d) {
+                // positional order is the field order, not the registration order
+                d->Getter("z", &Point::z);
+                d->Getter("y", &Point::y);
+                d->Setter("x", &Point::x);
+            })
+            .LuaNewType(L);
+        lua_setglobal(L, "Point");
+    }
+
+    auto result = luaL_dostring(L, R""(
+return Point.sum({1, 2, 3}), Point.sum({x = 1, y = 2, z = 4}), Point.z({1, 2, 3}), Point.sum({y = 5})
+)"");
+    REQUIRE(LUA_OK == result);
+    REQUIRE(6 == lua_tonumber(L, -4));
+    REQUIRE(7 == lua_tonumber(L, -3));
+    REQUIRE(3 == lua_tonumber(L, -2));
+    REQUIRE(5 == lua_tonumber(L, -1));
+    lua_settop(L, 0);
+
+    // raw access. __index of the table is not called
+    result = luaL_dostring(L, R""(
+local t = setmetatable({x = 1}, {__index = function(t, k) error('__index ' .. k) end})
+return Point.sum(t)
+)"");
+    REQUIRE(LUA_OK == result);
+    REQUIRE(1 == lua_tonumber(L, -1));
+    lua_settop(L, 0);
+
+    perilune::LuaTable<Point>::Push(L, Point{1, 2, 3});
+    REQUIRE(LUA_TTABLE == lua_type(L, -1));
+    lua_getfield(L, -1, "x");
+    lua_getfield(L, -2, "z");
+    REQUIRE(1 == lua_tonumber(L, -2));
+    REQUIRE(3 == lua_tonumber(L, -1));
+
+    lua_close(L);
+}
+
+namespace
+{
+
+struct Scalar3
+{
+    float x = 0;
+    float y = 0;
+    float z = 0;
+};
+
+} // namespace
+
+TEST_CASE("return as scalars", "[value]")
+{
+    auto L = luaL_newstate();
+    luaL_openlibs(L);
+
+    {
+        static perilune::UserType<Scalar3> scalar3Type;
+        scalar3Type
+            .ReturnAsScalars()
+            .StaticMethod("new", [](float x, float y, float z) { return Scalar3{x, y, z}; })
+            .StaticMethod("scale", [](const Scalar3 &v, float s) { return Scalar3{v.x * s, v.y * s, v.z * s}; })
+            .StaticMethod("dot", [](Scalar3 a, Scalar3 b) { return a.x * b.x + a.y * b.y + a.z * b.z; })
+            .PlacementNew<float, float, float>("make")
+            .MetaMethod(perilune::MetaKey::__add, [](Scalar3 *a, Scalar3 *b) {
+                return Scalar3{a->x + b->x, a->y + b->y, a->z + b->z};
+            })
+            .MetaIndexDispatcher([](perilune::IndexDispatcher<Scalar3> *d) {
+                d->Getter("x", &Scalar3::x);
+                d->Getter("y", &Scalar3::y);
+                d->Getter("z", &Scalar3::z);
+                d->Getter("doubled", [](Scalar3 *v) { return Scalar3{v->x * 2, v->y * 2, v->z * 2}; });
+            })
+            .LuaNewType(L);
+        lua_setglobal(L, "Scalar3");
+
+        // userdata argument
+        static perilune::UserType<Scalar3 *> scalar3PointerType;
+        scalar3PointerType
+            .StaticMethod("get", []() {
+                static Scalar3 s_value{1, 1, 1};
+                return &s_value;
+            })
+            .LuaNewType(L);
+        lua_setglobal(L, "Scalar3Pointer");
+    }
+
+    auto result = luaL_dostring(L, R""(
+local x, y, z = Scalar3.new(1, 2, 3)
+local n = select('#', Scalar3.new(1, 2, 3))
+local sx, sy, sz = Scalar3.scale(x, y, z, 2)
+local d = Scalar3.dot(sx, sy, sz, 1, 1, 1)
+local p = Scalar3.dot(Scalar3Pointer.get(), x, y, z)
+local t = Scalar3.dot({1, 0, 0}, Scalar3.new(5, 6, 7))
+return n, sz, d, p, t
+)"");
+    REQUIRE(LUA_OK == result);
+    REQUIRE(3 == lua_tointeger(L, -5));
+    REQUIRE(6 == lua_tonumber(L, -4));
+    REQUIRE(12 == lua_tonumber(L, -3));
+    REQUIRE(6 == lua_tonumber(L, -2));
+    REQUIRE(5 == lua_tonumber(L, -1));
+    lua_settop(L, 0);
+
+    // lua keeps one value of a metamethod or getter. fails loudly
+    result = luaL_dostring(L, R""(
+local a = Scalar3.make(1, 2, 3)
+local b = Scalar3.make(4, 5, 6)
+return a.y, a + b
+)"");
+    REQUIRE(LUA_OK != result);
+    REQUIRE(std::string(lua_tostring(L, -1)).find("scalars") != std::string::npos);
+    lua_settop(L, 0);
+
+    result = luaL_dostring(L, "return Scalar3.make(1, 2, 3).doubled");
+    REQUIRE(LUA_OK != result);
+    REQUIRE(std::string(lua_tostring(L, -1)).find("scalars") != std::string::npos);
+    lua_settop(L, 0);
+
+    // lvalue and rvalue pushes fail the same
+    lua_CFunction pushLvalue = [](lua_State *L) {
+        Scalar3 value{1, 2, 3};
+        return perilune::LuaPush<Scalar3>::Push(L, value);
+    };
+    lua_CFunction pushRvalue = [](lua_State *L) {
+        return perilune::LuaPush<Scalar3>::Push(L, Scalar3{1, 2, 3});
+    };
+    lua_register(L, "push_lvalue", pushLvalue);
+    lua_register(L, "push_rvalue", pushRvalue);
+    result = luaL_dostring(L, R""(
+local ok1, e1 = pcall(push_lvalue)
+local ok2, e2 = pcall(push_rvalue)
+return ok1 or ok2, e1, e2
+)"");
+    REQUIRE(LUA_OK == result);
+    REQUIRE(!lua_toboolean(L, -3));
+    REQUIRE(std::string(lua_tostring(L, -2)).find("scalars") != std::string::npos);
+    REQUIRE(std::string(lua_tostring(L, -1)).find("scalars") != std::string::npos);
+
+    lua_close(L);
+}
+
+TEST_CASE("return as scalars per state", "[value]")
+{
+    // the same T without ReturnAsScalars in another lua_State
+    auto L = luaL_newstate();
+    luaL_openlibs(L);
+
+    {
+        static perilune::UserType<Scalar3> scalar3Type;
+        scalar3Type
+            .StaticMethod("new", [](float x, float y, float z) { return Scalar3{x, y, z}; })
+            .MetaIndexDispatcher([](perilune::IndexDispatcher<Scalar3> *d) {
+                d->Getter("x", &Scalar3::x);
+                d->Getter("y", &Scalar3::y);
+                d->Getter("z", &Scalar3::z);
+            })
+            .LuaNewType(L);
+        lua_setglobal(L, "Scalar3");
+    }
+
+    auto result = luaL_dostring(L, R""(
+return select('#', Scalar3.new(1, 2, 3)), Scalar3.new(1, 2, 3).z
+)"");
+    REQUIRE(LUA_OK == result);
+    REQUIRE(1 == lua_tointeger(L, -2));
+    REQUIRE(3 == lua_tonumber(L, -1));
+
+    lua_close(L);
+}
+
+namespace
+{
+
+struct Accumulator
+{
+    int Value = 0;
+
+    Accumulator &operator+=(const Accumulator &rhs)
+    {
+        Value += rhs.Value;
+        return *this;
+    }
+
+    Accumulator &operator*=(int rhs)
+    {
+        Value *= rhs;
+        return *this;
+    }
+};
+
+} // namespace
+
+TEST_CASE("in place method", "[value]")
+{
+    auto L = luaL_newstate();
+    luaL_openlibs(L);
+
+    {
+        static perilune::UserType<Accumulator> accumulatorType;
+        accumulatorType
+            .StaticMethod("new", [](int n) { return Accumulator{n}; })
+            .MetaIndexDispatcher([](perilune::IndexDispatcher<Accumulator> *d) {
+                d->Getter("value", &Accumulator::Value);
+                d->InPlaceAdd();
+                d->InPlaceMul<int>("scale_");
+                d->InPlaceMethod("negate_", [](Accumulator *self) { self->Value = -self->Value; });
+            })
+            .LuaNewType(L);
+        lua_setglobal(L, "Accumulator");
+    }
+
+    auto result = luaL_dostring(L, R""(
+local acc = Accumulator.new(0)
+local one = Accumulator.new(1)
+for i = 1, 3 do acc.add_(one) end
+local same = acc.scale_(2) == acc
+return acc.value, same, acc.negate_().value
+)"");
+    REQUIRE(LUA_OK == result);
+    REQUIRE(6 == lua_tointeger(L, -3));
+    REQUIRE(lua_toboolean(L, -2));
+    REQUIRE(-6 == lua_tointeger(L, -1));
+
+    lua_close(L);
+}
+
+TEST_CASE("in place method colon call", "[value]")
+{
+    struct Counter
+    {
+        int Value = 0;
+
+        Counter &operator-=(const Counter &rhs)
+        {
+            Value -= rhs.Value;
+            return *this;
+        }
+    };
+
+    auto L = luaL_newstate();
+    luaL_openlibs(L);
+
+    {
+        static perilune::UserType<Counter> counterType;
+        counterType
+            .ColonCall()
+            .StaticMethod("new", [](int n) { return Counter{n}; })
+            .MetaIndexDispatcher([](perilune::IndexDispatcher<Counter> *d) {
+                d->Getter("value", &Counter::Value);
+                d->InPlaceSub();
+            })
+            .LuaNewType(L);
+        lua_setglobal(L, "Counter");
+    }
+
+    auto result = luaL_dostring(L, R""(
+local c = Counter.new(10)
+local one = Counter.new(1)
+return c:sub_(one):sub_(one) == c, c.value
+)"");
+    REQUIRE(LUA_OK == result);
+    REQUIRE(lua_toboolean(L, -2));
+    REQUIRE(8 == lua_tointeger(L, -1));
+
+    lua_close(L);
+}